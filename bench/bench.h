@@ -0,0 +1,30 @@
+#ifndef PROGRAM_PARAMS_BENCH_H
+#define PROGRAM_PARAMS_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+
+typedef std::chrono::steady_clock Clock;
+
+/** Best time per call of f in ns, over several runs of at least min_ns. */
+template<typename F>
+double measure(F f, double min_ns = 2e7)
+{
+    double best = 1e300;
+    for (int run = 0; run < 5; ++run)
+    {
+        size_t n = 0;
+        auto start = Clock::now();
+        std::chrono::duration<double, std::nano> elapsed;
+        do
+        {
+            f();
+            ++n;
+            elapsed = Clock::now() - start;
+        } while (elapsed.count() < min_ns);
+        best = std::min(best, elapsed.count() / n);
+    }
+    return best;
+}
+
+#endif //PROGRAM_PARAMS_BENCH_H
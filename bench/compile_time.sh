@@ -0,0 +1,46 @@
+#!/bin/sh
+# Compile time and object size of translation units registering 0, 10, 100
+# and 1,000 parameters of mixed types.
+#
+# Usage: compile_time.sh [compiler] [include dir] [flags...]
+
+CXX=${1:-c++}
+INCLUDE=${2:-$(dirname "$0")/../include}
+[ $# -ge 2 ] && shift 2 || shift $#
+FLAGS=${*:--std=c++11 -O2}
+
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+# Generate a translation unit with n parameters.
+generate() {
+    n=$1
+    echo '#include <program_params/program_params.h>'
+    echo 'using namespace program_params;'
+    echo 'void declare(Params &params)'
+    echo '{'
+    i=0
+    while [ $i -lt "$n" ]; do
+        case $((i % 6)) in
+            0) echo "    static int v$i; params.add(v$i, {\"--int-$i\"}).range(0, 100);" ;;
+            1) echo "    static unsigned long v$i; params.add(v$i, {\"--size-$i\"}).power_of_two();" ;;
+            2) echo "    static double v$i; params.add(v$i, {\"--ratio-$i\"}).positive();" ;;
+            3) echo "    static std::string v$i; params.add(v$i, {\"--name-$i\"});" ;;
+            4) echo "    static bool v$i; params.add(v$i, {\"--flag-$i\"});" ;;
+            5) echo "    static Decimal<2> v$i; params.add(v$i, {\"--price-$i\"});" ;;
+        esac
+        i=$((i + 1))
+    done
+    echo '}'
+}
+
+printf '%10s %12s %14s\n' params 'time [ms]' 'object [KB]'
+for n in 0 10 100 1000; do
+    generate $n > "$DIR/tu$n.cpp"
+    start=$(date +%s%N)
+    # shellcheck disable=SC2086
+    $CXX $FLAGS -I"$INCLUDE" -c "$DIR/tu$n.cpp" -o "$DIR/tu$n.o" || exit 1
+    end=$(date +%s%N)
+    size=$(wc -c < "$DIR/tu$n.o")
+    printf '%10d %12d %14d\n' $n $(((end - start) / 1000000)) $((size / 1024))
+done
@@ -0,0 +1,108 @@
+/*
+Throughput of argument classification and parsing for large argument vectors.
+
+Compares classification as done by the original parse loop (std::string copy
+and find per argument), scalar strlen and memchr, and the SIMD pre-scan, and
+reports the full parse time using the pre-scan.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <program_params/program_params.h>
+#include "bench.h"
+
+int main()
+{
+    const int options = 100;
+    std::vector<int> values(options);
+    bool a = false, b = false, v = false;
+    int count = 0;
+    program_params::Params params;
+    for (int i = 0; i < options; ++i)
+    {
+        params.add(values[i], {"--option-" + std::to_string(i)});
+    }
+    params.add(a, {"-a"});
+    params.add(b, {"-b"});
+    params.add(v, {"-v"});
+    params.add(count, {"-c", "--count"});
+    params.freeze();
+
+    std::cout << std::setw(10) << "arguments"
+              << std::setw(14) << "string ns/arg"
+              << std::setw(14) << "scalar ns/arg"
+              << std::setw(14) << "simd ns/arg"
+              << std::setw(14) << "parse ns/arg" << std::endl;
+    for (size_t n: {1000, 10000, 100000, 500000})
+    {
+        std::vector<std::string> storage;
+        for (size_t i = 0; storage.size() < n; ++i)
+        {
+            switch (i % 4)
+            {
+            case 0:
+                storage.push_back("--option-" + std::to_string(i % options)
+                                  + "=" + std::to_string(i));
+                break;
+            case 1:
+                storage.push_back("-abv");
+                break;
+            case 2:
+                storage.push_back("--count");
+                storage.push_back(std::to_string(i));
+                break;
+            default:
+                storage.push_back("-c" + std::to_string(i));
+            }
+        }
+        storage.resize(n);
+        if (storage.back() == "--count")
+        {
+            storage.back() = "-a";
+        }
+        std::vector<char *> argv;
+        for (auto &s: storage)
+        {
+            argv.push_back(&s[0]);
+        }
+
+        size_t sink = 0;
+        double string_ns = measure([&]()
+        {
+            for (char *arg: argv)
+            {
+                const std::string s(arg);
+                sink += s.find('=') + s.size();
+            }
+        });
+        double scalar_ns = measure([&]()
+        {
+            for (char *arg: argv)
+            {
+                size_t size, eq;
+                program_params::scan_scalar(arg, size, eq);
+                sink += size + eq;
+            }
+        });
+        double simd_ns = measure([&]()
+        {
+            for (char *arg: argv)
+            {
+                size_t size, eq;
+                program_params::scan_simd(arg, size, eq);
+                sink += size + eq;
+            }
+        });
+        double parse_ns = measure([&]()
+        {
+            params.reset();
+            params.parse(int(argv.size()), argv.data());
+        });
+        std::cout << std::setw(10) << n << std::fixed << std::setprecision(2)
+                  << std::setw(14) << string_ns / n
+                  << std::setw(14) << scalar_ns / n
+                  << std::setw(14) << simd_ns / n
+                  << std::setw(14) << parse_ns / n
+                  << (sink == 0 ? " " : "") << std::endl;
+    }
+}
@@ -0,0 +1,100 @@
+/*
+Parse time of adversarial command lines, checking it grows linearly with input
+size. Exits with non-zero status if any case grows faster.
+
+Nested response files are not covered, they are not supported by the library.
+*/
+
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <program_params/program_params.h>
+#include "bench.h"
+
+/** Arguments of a case for given size. */
+typedef std::function<std::vector<std::string>(size_t)> Generator;
+
+struct Case
+{
+    const char *name;
+    bool strict;
+    size_t size;    // Smallest size, doubled three times.
+    Generator generate;
+};
+
+int main()
+{
+    const Case cases[] = {
+        {"short cluster (64 KB)", true, 8 << 10,
+            [](size_t n) { return std::vector<std::string>{"-" + std::string(n, 'a')}; }},
+        {"unknown short cluster (64 KB)", false, 8 << 10,
+            [](size_t n) { return std::vector<std::string>{"-" + std::string(n, 'z')}; }},
+        {"long option value (1 MB)", true, 128 << 10,
+            [](size_t n) { return std::vector<std::string>{"--name=" + std::string(n, 'x')}; }},
+        {"positional value (1 MB)", true, 128 << 10,
+            [](size_t n) { return std::vector<std::string>{std::string(n, 'x')}; }},
+        {"repeated -- (1 M)", false, 128 << 10,
+            [](size_t n) { return std::vector<std::string>(n, "--"); }},
+        {"unknown long options", false, 1 << 10,
+            [](size_t n)
+            {
+                std::vector<std::string> args;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    args.push_back("--unknown-" + std::to_string(i));
+                }
+                return args;
+            }},
+        {"unknown positionals", false, 1 << 10,
+            [](size_t n) { return std::vector<std::string>(n, "file"); }},
+    };
+
+    bool ok = true;
+    std::cout << std::left << std::setw(32) << "case" << std::right
+              << std::setw(10) << "size" << std::setw(14) << "time [us]"
+              << std::setw(14) << "ns/unit" << std::endl;
+    for (const Case &c: cases)
+    {
+        double first = 0;
+        double last = 0;
+        for (size_t k = 0; k < 4; ++k)
+        {
+            const size_t n = c.size << k;
+            std::vector<std::string> args = c.generate(n);
+            std::vector<char *> argv;
+            for (auto &arg: args)
+            {
+                argv.push_back(&arg[0]);
+            }
+            bool a = false;
+            std::string name;
+            std::string positional;
+            program_params::Params params(c.strict);
+            params.add(a, {"-a"});
+            params.add(name, {"--name"});
+            params.add(positional, {"positional"});
+            params.freeze();
+            double ns = measure([&]()
+            {
+                params.reset();
+                params.parse(int(argv.size()), argv.data());
+            }, 1e7);
+            (k == 0 ? first : last) = ns;
+            std::cout << std::left << std::setw(32) << (k == 0 ? c.name : "")
+                      << std::right << std::setw(10) << n
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(14) << ns / 1e3
+                      << std::setprecision(2) << std::setw(14) << ns / n << std::endl;
+        }
+        // Growth exponent over the 8x size range, 1 for linear time, 2 for
+        // quadratic, with margin for cache effects of large inputs.
+        double exponent = std::log(last / first) / std::log(8.0);
+        bool linear = exponent < 1.5;
+        ok = ok && linear;
+        std::cout << std::left << std::setw(32) << "" << "growth exponent "
+                  << std::setprecision(2) << exponent
+                  << (linear ? "" : "  FAIL: superlinear") << std::endl;
+    }
+    return ok ? 0 : 1;
+}
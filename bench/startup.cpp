@@ -0,0 +1,183 @@
+/*
+Startup cost of building large schemas: time and allocations of add, freeze
+and bulk loading from a serialized schema, and static-initialization cost of
+parameters registered from many places (e.g., translation units) into a
+global registry. Reports whether the 5,000-option schema is built within
+budget, by add and freeze or by loading, which depends on the machine.
+*/
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <program_params/schema.h>
+#include "bench.h"
+
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    if (void *p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// Inlined into delete expressions, free looks mismatched with new to GCC.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+/** Global registry for parameters registered during static initialization. */
+program_params::Params &registry()
+{
+    static program_params::Params params;
+    return params;
+}
+
+/** Parameter registered on construction, e.g., a static in some source file. */
+struct Registered
+{
+    Registered():
+            value(0)
+    {
+        static size_t next = 0;
+        registry().add(value, {"--static-" + std::to_string(next++)});
+    }
+    int value;
+};
+
+const size_t registered_count = 5000;
+static Clock::time_point static_start = Clock::now();
+static size_t static_allocations = allocations;
+static Registered registered[registered_count];
+static Clock::time_point static_end = Clock::now();
+static size_t static_allocations_end = allocations;
+
+/** Names and targets of a synthetic schema. */
+struct Targets
+{
+    std::vector<std::string> names;
+    std::vector<int> ints;
+    std::vector<std::string> strings;
+    std::unique_ptr<bool[]> flags;
+};
+
+/** Best time of f in ns over runs, excluding destruction of what it builds. */
+template<typename F>
+double measure_build(F f, int runs)
+{
+    double best = 1e300;
+    for (int run = 0; run < runs; ++run)
+    {
+        program_params::Params params;
+        auto start = Clock::now();
+        f(params);
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+/** Add n parameters of mixed types, names prepared in advance. */
+void build(program_params::Params &params, Targets &s)
+{
+    size_t n = s.names.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        switch (i % 3)
+        {
+        case 0:
+            params.add(s.ints[i], {s.names[i]});
+            break;
+        case 1:
+            params.add(s.strings[i], {s.names[i]});
+            break;
+        default:
+            params.add(s.flags[i], {s.names[i]});
+            break;
+        }
+    }
+}
+
+int main()
+{
+    const double budget_ms = 1.0;
+    const size_t budget_size = 5000;
+
+    std::cout << std::setw(10) << "params"
+              << std::setw(12) << "add [us]" << std::setw(12) << "allocs"
+              << std::setw(14) << "freeze [us]" << std::setw(12) << "load [us]"
+              << std::setw(12) << "allocs" << std::setw(14) << "ns/param" << std::endl;
+    for (size_t n: {100, 1000, 5000, 10000, 100000})
+    {
+        Targets s;
+        for (size_t i = 0; i < n; ++i)
+        {
+            s.names.push_back("--option-" + std::to_string(i));
+        }
+        s.ints.resize(n);
+        s.strings.resize(n);
+        s.flags.reset(new bool[n]());
+
+        int runs = n < 10000 ? 50 : 5;
+        double add = measure_build([&](program_params::Params &params) { build(params, s); },
+                                   runs);
+        size_t before = allocations;
+        program_params::Params params;
+        build(params, s);
+        size_t add_allocs = allocations - before;
+
+        double freeze = measure([&]() { params.freeze(); }, n < 10000 ? 2e7 : 2e8);
+
+        std::string data = program_params::save_schema(params);
+        program_params::Schema schema{program_params::StrRef(data)};
+        double load = measure_build([&](program_params::Params &loaded)
+        {
+            program_params::load_schema(loaded, schema);
+        }, runs);
+        before = allocations;
+        {
+            program_params::Params loaded;
+            program_params::load_schema(loaded, schema);
+        }
+        size_t load_allocs = allocations - before;
+
+        std::cout << std::setw(10) << n << std::fixed << std::setprecision(1)
+                  << std::setw(12) << add / 1e3 << std::setw(12) << add_allocs
+                  << std::setw(14) << freeze / 1e3 << std::setw(12) << load / 1e3
+                  << std::setw(12) << load_allocs
+                  << std::setw(14) << (add + freeze) / n << std::endl;
+
+        if (n == budget_size)
+        {
+            double ms = (add + freeze) / 1e6;
+            std::cout << std::setw(10) << "" << "add and freeze " << std::setprecision(3) << ms
+                      << " ms, load " << load / 1e6 << " ms, budget " << budget_ms << " ms"
+                      << (std::min(ms, load / 1e6) < budget_ms ? "" : "  over budget")
+                      << std::endl;
+        }
+    }
+
+    std::chrono::duration<double, std::micro> static_time = static_end - static_start;
+    std::cout << "static registration of " << registered_count << " params: "
+              << std::setprecision(1) << static_time.count() << " us, "
+              << static_allocations_end - static_allocations << " allocs" << std::endl;
+    return 0;
+}
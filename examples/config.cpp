@@ -0,0 +1,32 @@
+#include <iostream>
+#include <program_params/config.h>
+
+int main (int argc, char *argv[])
+{
+    std::string config = "app.conf";
+    unsigned count = 0;
+    std::string name;
+    std::string host;
+    unsigned port = 0;
+    program_params::Params params;
+    params.add(config, {"--config"});
+    params.add(count, {"-c", "--count"});
+    params.add(name, {"--name"});
+    params.add(host, {"--host"});
+    params.add(port, {"--port"}).range(1, 65535);
+    try
+    {
+        // Find the config file first, then let the command line override it.
+        params.parse(argc - 1, argv + 1);
+        program_params::Config(config).apply(params);
+        params.reset();
+        params.parse(argc - 1, argv + 1);
+    }
+    catch (const program_params::Exception &ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    std::cout << name << ": " << count << " x " << host << ":" << port << std::endl;
+    return 0;
+}
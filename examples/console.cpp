@@ -0,0 +1,52 @@
+#include <iostream>
+#include <program_params/dispatcher.h>
+
+struct Scale
+{
+    unsigned replicas = 1;
+    std::string service;
+};
+
+struct Status
+{
+    bool verbose = false;
+};
+
+int main()
+{
+    program_params::Dispatcher dispatcher;
+    dispatcher.add<Scale>("scale",
+            [](program_params::Params &params, Scale &args)
+            {
+                params.add(args.replicas, {"-r", "--replicas"}).range(0, 100);
+                params.add(args.service, {}, true);
+            },
+            [](Scale &args)
+            {
+                std::cout << "Scaling " << args.service << " to " << args.replicas << std::endl;
+            });
+    dispatcher.add<Status>("status",
+            [](program_params::Params &params, Status &args)
+            {
+                params.add(args.verbose, {"-v", "--verbose"});
+            },
+            [](Status &args)
+            {
+                std::cout << "Status" << (args.verbose ? " (verbose)" : "") << std::endl;
+            });
+
+    auto context = dispatcher.context();
+    std::string line;
+    while (std::getline(std::cin, line))
+    {
+        try
+        {
+            dispatcher.execute(context, line);
+        }
+        catch (const program_params::Exception &ex)
+        {
+            std::cout << ex.what() << std::endl;
+            std::cout << "Commands: scale [-r <replicas>] <service>, status [-v]" << std::endl;
+        }
+    }
+}
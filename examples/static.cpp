@@ -0,0 +1,34 @@
+#include <iostream>
+#include <program_params/static_params.h>
+
+using program_params::Opt;
+using program_params::Required;
+
+int main (int argc, char *argv[])
+{
+    typedef program_params::StaticParams<
+            Opt<bool, "-a", "--audible">,
+            Opt<size_t, "-c", "--count">,
+            Opt<float, "-i", "--interval">,
+            Required<std::string, "destination">> Schema;
+    // Defaults parsed at compile time.
+    constexpr auto defaults = Schema::parse_constant({"--count", "10", "--interval", "1.0"});
+    Schema params(defaults);
+    params.param<"--count">().range(1, 100);
+
+    try
+    {
+        params.parse(argc - 1, argv + 1);
+    }
+    catch (const program_params::Exception &ex)
+    {
+        std::cout << ex.what() << std::endl;
+        std::cout << "Example: static -a -c 10 -i 2.5 192.168.0.1" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Audible: " << params.get<"-a">() << std::endl;
+    std::cout << "Count: " << params.get<"--count">() << std::endl;
+    std::cout << "Interval: " << params.get<"--interval">() << std::endl;
+    std::cout << "Destination: " << params.get<"destination">() << std::endl;
+}
@@ -0,0 +1,32 @@
+#include <iostream>
+#include <program_params/usage.h>
+
+int main (int argc, char *argv[])
+{
+    bool audible = false;
+    size_t count = 10;
+    float interval = 1.0f;
+    std::string destination;
+
+    program_params::Params params;
+    auto usage = PROGRAM_PARAMS_USAGE(params,
+            "usage [-a] [-c|--count <count>] [-i|--interval <interval>] <destination>",
+            audible, count, interval, destination);
+
+    try
+    {
+        params.parse(argc - 1, argv + 1);
+    }
+    catch (const program_params::Exception &ex)
+    {
+        std::cout << ex.what() << std::endl;
+        std::cout << "Usage:   " << usage.pattern() << std::endl;
+        std::cout << "Example: usage -a -c 10 -i 2.5 192.168.0.1" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Audible: " << audible << std::endl;
+    std::cout << "Count: " << count << std::endl;
+    std::cout << "Interval: " << interval << std::endl;
+    std::cout << "Destination: " << destination << std::endl;
+}
@@ -0,0 +1,324 @@
+/*
+Config files of key = value lines as a source of parameter values:
+
+    # Comments take whole lines, values extend to the end of line.
+    count = 5
+    name = "  with spaces  "
+    include common.conf
+
+Keys name long options without dashes (count sets --count) or any option
+with dashes (-c), quotes around values are optional, included paths are
+relative to the including file. Lines with = are key = value lines, so
+include = 5 sets --include and included paths cannot contain =.
+
+Loading discovers the include graph level by level, files of each level are
+mapped and split into entries concurrently by a pool of threads. Entries are
+then applied in a deterministic order independent of the threads: in file
+order, with included files expanded at their include (a file included
+several times is applied at each include), so later entries win. Include
+cycles are errors.
+
+    program_params::Config config("app.conf");
+    config.apply(params);
+    params.parse(argc, argv);   // Command line overrides config.
+*/
+
+#ifndef PROGRAM_PARAMS_CONFIG_H
+#define PROGRAM_PARAMS_CONFIG_H
+
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <program_params/program_params.h>
+
+namespace program_params
+{
+
+struct ConfigEntry
+{
+    StrRef key;         // Empty for include.
+    StrRef value;       // Value or included path.
+    uint32_t line;
+    uint32_t file;      // Index of included file.
+};
+
+/** Config file mapped and split into entries. */
+class ConfigFile
+{
+public:
+    explicit ConfigFile(const Str &path):
+            path_(path), file_(open(path))
+    {
+        const char *p = file_->ref().data();
+        const char *end = p + file_->ref().size();
+        for (uint32_t line = 1; p < end; ++line)
+        {
+            const char *eol = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+            if (!eol)
+            {
+                eol = end;
+            }
+            parse_line(StrRef(p, size_t(eol - p)), line);
+            p = eol + 1;
+        }
+    }
+
+    const Str &path() const
+    {
+        return path_;
+    }
+    const std::vector<ConfigEntry> &entries() const
+    {
+        return entries_;
+    }
+    std::vector<ConfigEntry> &entries()
+    {
+        return entries_;
+    }
+    /** Error message with file and line. */
+    Str where(uint32_t line, const Str &what) const
+    {
+        return path_ + ":" + std::to_string(line) + ": " + what;
+    }
+private:
+    static std::unique_ptr<MappedFile> open(const Str &path)
+    {
+        try
+        {
+            return std::unique_ptr<MappedFile>(new MappedFile(path));
+        }
+        catch (const Exception &)
+        {
+            throw Exception(path + ": Cannot read config file.");
+        }
+    }
+    static bool is_space(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+    static StrRef trim(const char *p, const char *end)
+    {
+        while (p < end && is_space(*p))
+        {
+            ++p;
+        }
+        while (p < end && is_space(end[-1]))
+        {
+            --end;
+        }
+        if (end - p >= 2 && (*p == '"' || *p == '\'') && end[-1] == *p)
+        {
+            ++p;
+            --end;
+        }
+        return StrRef(p, size_t(end - p));
+    }
+    void parse_line(const StrRef &text, uint32_t line)
+    {
+        const char *p = text.data();
+        const char *end = p + text.size();
+        while (p < end && is_space(*p))
+        {
+            ++p;
+        }
+        if (p == end || *p == '#')
+        {
+            return;
+        }
+        // Lines with = set values, e.g., include = 5 sets --include.
+        const char *eq = static_cast<const char *>(std::memchr(p, '=', size_t(end - p)));
+        const size_t n = sizeof("include") - 1;
+        if (!eq && size_t(end - p) > n && std::memcmp(p, "include", n) == 0 && is_space(p[n]))
+        {
+            entries_.push_back(ConfigEntry{StrRef(), trim(p + n, end), line, 0});
+            return;
+        }
+        StrRef key = eq ? trim(p, eq) : StrRef();
+        if (key.empty())
+        {
+            throw Exception(where(line, "Invalid config line."));
+        }
+        entries_.push_back(ConfigEntry{key, trim(eq + 1, end), line, 0});
+    }
+
+    Str path_;
+    std::unique_ptr<MappedFile> file_;
+    std::vector<ConfigEntry> entries_;
+};
+
+/** Config file with all files it includes. */
+class Config
+{
+public:
+    /** Load root config file and its includes, by up to threads at once (0 for all cores). */
+    explicit Config(const Str &path, unsigned threads = 0)
+    {
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        std::vector<Str> pending(1, canonical(path, path + ": Cannot read config file."));
+        paths_[pending[0]] = 0;
+        while (!pending.empty())
+        {
+            size_t first = files_.size();
+            load(pending, threads);
+            pending.clear();
+            // Resolve includes of the new level, in order of files and entries.
+            for (size_t i = first; i < files_.size(); ++i)
+            {
+                ConfigFile &file = *files_[i];
+                for (auto &e: file.entries())
+                {
+                    if (!e.key.empty())
+                    {
+                        continue;
+                    }
+                    Str target = canonical(resolve(file.path(), e.value),
+                                           file.where(e.line, "Cannot read included file."));
+                    auto it = paths_.find(target);
+                    if (it == paths_.end())
+                    {
+                        it = paths_.emplace(target, uint32_t(files_.size() + pending.size())).first;
+                        pending.push_back(target);
+                    }
+                    e.file = it->second;
+                }
+            }
+        }
+        std::vector<uint8_t> state(files_.size(), 0);
+        check_cycles(0, state);
+    }
+
+    /** Set parameters from all entries, later entries win. */
+    void apply(Params &params) const
+    {
+        Str name;
+        apply(params, 0, name);
+    }
+    /** Files in order of discovery, the root first. */
+    const std::vector<std::unique_ptr<ConfigFile>> &files() const
+    {
+        return files_;
+    }
+private:
+    static Str canonical(const Str &path, const Str &error)
+    {
+#ifdef PROGRAM_PARAMS_POSIX
+        char *p = ::realpath(path.c_str(), nullptr);
+        if (!p)
+        {
+            throw Exception(error);
+        }
+        Str s(p);
+        std::free(p);
+        return s;
+#else
+        // Without realpath, files are identified by their paths as given.
+        if (!std::ifstream(path.c_str()))
+        {
+            throw Exception(error);
+        }
+        return path;
+#endif
+    }
+    /** Path relative to the directory of the including file. */
+    static Str resolve(const Str &from, const StrRef &path)
+    {
+        if (path.size() > 0 && path[0] == '/')
+        {
+            return path.str();
+        }
+        return from.substr(0, from.rfind('/') + 1) + path.str();
+    }
+
+    /** Map and split files, in parallel, and report the first error in order. */
+    void load(const std::vector<Str> &paths, unsigned threads)
+    {
+        size_t first = files_.size();
+        files_.resize(first + paths.size());
+        std::vector<std::exception_ptr> errors(paths.size());
+        std::atomic<size_t> next(0);
+        auto work = [&]()
+        {
+            for (size_t i; (i = next++) < paths.size();)
+            {
+                try
+                {
+                    files_[first + i].reset(new ConfigFile(paths[i]));
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            }
+        };
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < std::min<size_t>(threads, paths.size()); ++t)
+        {
+            pool.emplace_back(work);
+        }
+        work();
+        for (auto &t: pool)
+        {
+            t.join();
+        }
+        for (const auto &e: errors)
+        {
+            if (e)
+            {
+                std::rethrow_exception(e);
+            }
+        }
+    }
+
+    /** Depth-first search over includes, state 1 marks files on the path. */
+    void check_cycles(uint32_t i, std::vector<uint8_t> &state) const
+    {
+        state[i] = 1;
+        for (const auto &e: files_[i]->entries())
+        {
+            if (!e.key.empty() || state[e.file] == 2)
+            {
+                continue;
+            }
+            if (state[e.file] == 1)
+            {
+                throw Exception(files_[i]->where(e.line, "Include cycle."));
+            }
+            check_cycles(e.file, state);
+        }
+        state[i] = 2;
+    }
+
+    void apply(Params &params, uint32_t i, Str &name) const
+    {
+        const ConfigFile &file = *files_[i];
+        for (const auto &e: file.entries())
+        {
+            if (e.key.empty())
+            {
+                apply(params, e.file, name);
+                continue;
+            }
+            // Keys without dashes name long options.
+            name.assign(e.key[0] == '-' ? "" : "--");
+            name.append(e.key.data(), e.key.size());
+            try
+            {
+                params.set(StrRef(name), e.value);
+            }
+            catch (const Exception &ex)
+            {
+                throw Exception(file.where(e.line, name + ": " + ex.what()));
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<ConfigFile>> files_;
+    std::unordered_map<Str, uint32_t> paths_;
+};
+
+}
+
+#endif //PROGRAM_PARAMS_CONFIG_H
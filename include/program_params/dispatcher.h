@@ -0,0 +1,206 @@
+/*
+Dispatcher of command lines, such as "scale --replicas 5 web", to handlers.
+
+Each command declares its parameters into an argument structure once per
+context, so a context (e.g., one per thread) keeps frozen parameters and
+result buffers of all commands. Executing a line splits it into views of the
+line and routes it by a perfect hash of command names, which allocates
+nothing unless the command itself does so.
+*/
+
+#ifndef PROGRAM_PARAMS_DISPATCHER_H
+#define PROGRAM_PARAMS_DISPATCHER_H
+
+#include <functional>
+#include <program_params/program_params.h>
+
+namespace program_params
+{
+
+/**
+ * Split line into whitespace-separated views, single or double quotes group
+ * words into a single token (without escapes).
+ */
+inline void split(const StrRef &line, std::vector<StrRef> &tokens)
+{
+    tokens.clear();
+    const char *p = line.data();
+    const char *end = p + line.size();
+    for (;;)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+        {
+            ++p;
+        }
+        if (p == end)
+        {
+            break;
+        }
+        if (*p == '"' || *p == '\'')
+        {
+            const char *q = static_cast<const char *>(
+                    std::memchr(p + 1, *p, size_t(end - p - 1)));
+            if (!q)
+            {
+                throw Exception("Unterminated quote.");
+            }
+            tokens.push_back(StrRef(p + 1, size_t(q - p - 1)));
+            p = q + 1;
+            continue;
+        }
+        const char *q = p;
+        while (q < end && *q != ' ' && *q != '\t' && *q != '\n' && *q != '\r')
+        {
+            ++q;
+        }
+        tokens.push_back(StrRef(p, size_t(q - p)));
+        p = q;
+    }
+}
+
+class Dispatcher
+{
+public:
+    Dispatcher():
+            frozen_(false)
+    {}
+
+    /** Command instance with its own parameters and arguments. */
+    class InstanceBase
+    {
+    public:
+        virtual ~InstanceBase()
+        {}
+        virtual void run(const StrRef *begin, const StrRef *end) = 0;
+    };
+
+    class CommandBase
+    {
+    public:
+        virtual ~CommandBase()
+        {}
+        virtual std::unique_ptr<InstanceBase> instance() const = 0;
+    };
+
+    template<typename Args>
+    class Command: public CommandBase
+    {
+    public:
+        typedef std::function<void(Params &, Args &)> Declare;
+        typedef std::function<void(Args &)> Handler;
+
+        Command(Declare declare, Handler handler, bool strict):
+                declare_(declare), handler_(handler), strict_(strict)
+        {}
+        virtual std::unique_ptr<InstanceBase> instance() const
+        {
+            return std::unique_ptr<InstanceBase>(new Instance<Args>(*this));
+        }
+        Declare declare_;
+        Handler handler_;
+        bool strict_;
+        /** Default arguments, restored before each execution. */
+        Args defaults_;
+    };
+
+    template<typename Args>
+    class Instance: public InstanceBase
+    {
+    public:
+        explicit Instance(const Command<Args> &command):
+                command_(command), params_(command.strict_), args_(command.defaults_)
+        {
+            command_.declare_(params_, args_);
+            params_.freeze();
+        }
+        virtual void run(const StrRef *begin, const StrRef *end)
+        {
+            args_ = command_.defaults_;
+            params_.reset();
+            params_.parse(begin, end);
+            command_.handler_(args_);
+        }
+    private:
+        const Command<Args> &command_;
+        Params params_;
+        Args args_;
+    };
+
+    /** Per-thread state of a dispatcher. */
+    class Context
+    {
+    public:
+        Context()
+        {}
+        Context(Context &&other) = default;
+        Context &operator=(Context &&other) = default;
+    private:
+        friend class Dispatcher;
+        std::vector<std::unique_ptr<InstanceBase>> instances_;
+        std::vector<StrRef> tokens_;
+    };
+
+    /**
+     * Add a command declaring parameters into Args and handling them.
+     * Args must be default constructible and copy assignable, its default
+     * values are used for parameters missing from the command line.
+     */
+    template<typename Args>
+    void add(const Str &name,
+             typename Command<Args>::Declare declare,
+             typename Command<Args>::Handler handler,
+             bool strict = true)
+    {
+        names_.push_back(name);
+        commands_.emplace_back(new Command<Args>(declare, handler, strict));
+        frozen_ = false;
+    }
+    /** Build command lookup, called automatically on first context. */
+    void freeze()
+    {
+        std::vector<StrRef> keys(names_.begin(), names_.end());
+        index_.build(keys);
+        frozen_ = true;
+    }
+    /** New context with instances of all commands. */
+    Context context()
+    {
+        if (!frozen_)
+        {
+            freeze();
+        }
+        Context ctx;
+        for (const auto &command: commands_)
+        {
+            ctx.instances_.push_back(command->instance());
+        }
+        ctx.tokens_.reserve(16);
+        return ctx;
+    }
+    /** Execute command line, empty lines are ignored. */
+    void execute(Context &ctx, const StrRef &line) const
+    {
+        assert(frozen_ && ctx.instances_.size() == commands_.size());
+        split(line, ctx.tokens_);
+        if (ctx.tokens_.empty())
+        {
+            return;
+        }
+        int32_t i = index_.find(ctx.tokens_.front());
+        if (i < 0)
+        {
+            throw Exception("Unknown command.");
+        }
+        const StrRef *begin = ctx.tokens_.data();
+        ctx.instances_[i]->run(begin + 1, begin + ctx.tokens_.size());
+    }
+private:
+    StrVec names_;
+    std::vector<std::unique_ptr<CommandBase>> commands_;
+    PerfectHash index_;
+    bool frozen_;
+};
+
+}
+
+#endif //PROGRAM_PARAMS_DISPATCHER_H
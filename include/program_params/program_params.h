@@ -16,11 +16,49 @@ resolved by the order of parameter declaration.
 #ifndef PROGRAM_PARAMS_PROGRAM_PARAMS_H
 #define PROGRAM_PARAMS_PROGRAM_PARAMS_H
 
+#include <algorithm>
+#include <array>
+#if defined(PROGRAM_PARAMS_COUNTERS) || defined(PROGRAM_PARAMS_HISTOGRAMS)
+#include <atomic>
+#endif
 #include <cassert>
+#include <cerrno>
+#ifdef PROGRAM_PARAMS_HISTOGRAMS
+#include <chrono>
+#endif
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <regex>
 #include <stdexcept>
+#include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#define PROGRAM_PARAMS_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
 
 namespace program_params
 {
@@ -31,27 +69,1741 @@ public:
     Exception(const char *what):
             std::runtime_error(what)
     {}
+    Exception(const std::string &what):
+            std::runtime_error(what)
+    {}
+};
+
+/** Invalid parameter value, with parameter name and argument index. */
+class ValueException: public Exception
+{
+public:
+    ValueException(const std::string &name, int index, const char *what):
+            Exception(name + " (argument " + std::to_string(index) + "): " + what),
+            name_(name), index_(index)
+    {}
+    const std::string &name() const
+    {
+        return name_;
+    }
+    int index() const
+    {
+        return index_;
+    }
+private:
+    std::string name_;
+    int index_;
+};
+
+inline bool is_option(const std::string &arg)
+{
+    return arg.size() > 0 && arg[0] == '-';
+}
+
+typedef std::string Str;
+typedef std::vector<Str> StrVec;
+typedef std::initializer_list<Str> StrInit;
+
+/**
+ * Non-owning view of characters, e.g., a part of an argument or a mapped file.
+ * Views need not be null-terminated.
+ */
+class StrRef
+{
+public:
+    static const size_t npos = size_t(-1);
+
+    StrRef():
+            data_(""), size_(0)
+    {}
+    StrRef(const char *data, size_t size):
+            data_(data), size_(size)
+    {}
+    StrRef(const char *str):
+            data_(str), size_(std::strlen(str))
+    {}
+    StrRef(const Str &str):
+            data_(str.data()), size_(str.size())
+    {}
+#if __cplusplus >= 201703L
+    StrRef(std::string_view str):
+            data_(str.data()), size_(str.size())
+    {}
+    operator std::string_view() const
+    {
+        return std::string_view(data_, size_);
+    }
+#endif
+    const char *data() const
+    {
+        return data_;
+    }
+    size_t size() const
+    {
+        return size_;
+    }
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+    char operator[](size_t i) const
+    {
+        assert(i < size_);
+        return data_[i];
+    }
+    size_t find(char c, size_t pos = 0) const
+    {
+        for (size_t i = pos; i < size_; ++i)
+        {
+            if (data_[i] == c)
+            {
+                return i;
+            }
+        }
+        return npos;
+    }
+    StrRef substr(size_t pos, size_t n = npos) const
+    {
+        assert(pos <= size_);
+        return StrRef(data_ + pos, std::min(n, size_ - pos));
+    }
+    Str str() const
+    {
+        return Str(data_, size_);
+    }
+    bool operator==(const StrRef &other) const
+    {
+        return size_ == other.size_ && std::memcmp(data_, other.data_, size_) == 0;
+    }
+    bool operator!=(const StrRef &other) const
+    {
+        return !(*this == other);
+    }
+private:
+    const char *data_;
+    size_t size_;
+};
+
+/**
+ * Perfect hash of a fixed set of keys, built by hash and displace:
+ * keys are distributed into buckets and each bucket gets a seed mapping all
+ * its keys to distinct free slots. Lookup hashes the key once, mixes the
+ * hash with the seed of its bucket and compares one key.
+ */
+class PerfectHash
+{
+public:
+    PerfectHash():
+            mask_(0)
+    {}
+
+    /** Build the table for distinct keys, copied into the table. */
+    void build(const std::vector<StrRef> &keys)
+    {
+        chars_.clear();
+        ends_.clear();
+        ends_.reserve(keys.size());
+        for (const auto &key: keys)
+        {
+            chars_.append(key.data(), key.size());
+            ends_.push_back(chars_.size());
+        }
+        size_t size = 1;
+        while (size < 2 * keys.size())
+        {
+            size *= 2;
+        }
+        mask_ = size - 1;
+        slots_.assign(size, -1);
+        seeds_.assign(keys.size() / 4 + 1, 0);
+        // Group keys by bucket in one array (counting sort).
+        std::vector<uint64_t> hashes(keys.size());
+        std::vector<uint32_t> bucket_of(keys.size());
+        std::vector<uint32_t> start(seeds_.size() + 1, 0);
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            hashes[i] = hash(keys[i]);
+            bucket_of[i] = uint32_t(hashes[i] % seeds_.size());
+            ++start[bucket_of[i] + 1];
+        }
+        for (size_t b = 0; b < seeds_.size(); ++b)
+        {
+            start[b + 1] += start[b];
+        }
+        std::vector<int32_t> members(keys.size());
+        std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            members[fill[bucket_of[i]]++] = int32_t(i);
+        }
+        std::vector<uint32_t> order(seeds_.size());
+        for (size_t b = 0; b < order.size(); ++b)
+        {
+            order[b] = uint32_t(b);
+        }
+        // Place larger buckets first, while there are more free slots.
+        std::stable_sort(order.begin(), order.end(), [&start](uint32_t a, uint32_t b)
+        {
+            return start[a + 1] - start[a] > start[b + 1] - start[b];
+        });
+        std::vector<size_t> placed;
+        for (uint32_t b: order)
+        {
+            const int32_t *first = members.data() + start[b];
+            const int32_t *last = members.data() + start[b + 1];
+            if (first == last)
+            {
+                break;
+            }
+            for (uint64_t seed = 1;; ++seed)
+            {
+                placed.clear();
+                for (const int32_t *k = first; k < last; ++k)
+                {
+                    size_t slot = mix(hashes[*k], seed) & mask_;
+                    if (slots_[slot] >= 0)
+                    {
+                        break;
+                    }
+                    slots_[slot] = *k;
+                    placed.push_back(slot);
+                }
+                if (placed.size() == size_t(last - first))
+                {
+                    seeds_[b] = seed;
+                    break;
+                }
+                for (size_t slot: placed)
+                {
+                    slots_[slot] = -1;
+                }
+                if (seed > 1000000)
+                {
+                    throw Exception("Duplicate perfect hash keys.");
+                }
+            }
+        }
+    }
+    /** Index of the key in the build keys, or -1 if not present. */
+    int32_t find(const StrRef &key) const
+    {
+        if (ends_.empty())
+        {
+            return -1;
+        }
+        uint64_t h = hash(key);
+        int32_t i = slots_[mix(h, seeds_[h % seeds_.size()]) & mask_];
+        if (i < 0)
+        {
+            return -1;
+        }
+        size_t begin = i > 0 ? ends_[i - 1] : 0;
+        return StrRef(chars_.data() + begin, ends_[i] - begin) == key ? i : -1;
+    }
+    static uint64_t hash(const StrRef &key)
+    {
+        // FNV-1a with final mix.
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < key.size(); ++i)
+        {
+            h = (h ^ uint8_t(key[i])) * 0x100000001b3ULL;
+        }
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+    /** Seeded slot hash derived from the key hash. */
+    static uint64_t mix(uint64_t h, uint64_t seed)
+    {
+        h += seed * 0x9e3779b97f4a7c15ULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+private:
+    /** Characters of all keys, key i ending at ends_[i]. */
+    Str chars_;
+    std::vector<size_t> ends_;
+    std::vector<uint64_t> seeds_;
+    std::vector<int32_t> slots_;
+    size_t mask_;
+};
+
+#ifdef PROGRAM_PARAMS_POSIX
+/**
+ * Read-only memory mapping of a value file.
+ * The mapping is padded with at least one zero byte past the end of the file
+ * and a single trailing line break is excluded from the value.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const Str &path):
+            addr_(MAP_FAILED), len_(0)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw Exception("Cannot open value file.");
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            ::close(fd);
+            throw Exception("Value file is not a regular file.");
+        }
+        size_t size = size_t(st.st_size);
+        if (size > 0)
+        {
+            // Reserve zeroed pages covering the file and at least one more
+            // byte, then map the file over them.
+            size_t page = size_t(::sysconf(_SC_PAGESIZE));
+            len_ = (size / page + 1) * page;
+            addr_ = ::mmap(nullptr, len_, PROT_READ,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (addr_ != MAP_FAILED
+                    && ::mmap(addr_, size, PROT_READ,
+                              MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+            {
+                ::munmap(addr_, len_);
+                addr_ = MAP_FAILED;
+            }
+        }
+        ::close(fd);
+        if (size > 0 && addr_ == MAP_FAILED)
+        {
+            throw Exception("Cannot map value file.");
+        }
+        if (size > 0)
+        {
+            const char *data = static_cast<const char *>(addr_);
+            if (data[size - 1] == '\n')
+            {
+                --size;
+                if (size > 0 && data[size - 1] == '\r')
+                {
+                    --size;
+                }
+            }
+            ref_ = StrRef(data, size);
+        }
+    }
+    ~MappedFile()
+    {
+        if (addr_ != MAP_FAILED)
+        {
+            ::munmap(addr_, len_);
+        }
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const StrRef &ref() const
+    {
+        return ref_;
+    }
+private:
+    void *addr_;
+    size_t len_;
+    StrRef ref_;
+};
+#else
+/**
+ * Value file read into memory, on systems without memory mapping.
+ * The contents are followed by a zero byte and a single trailing line break
+ * is excluded from the value.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const Str &path)
+    {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        if (!in)
+        {
+            throw Exception("Cannot open value file.");
+        }
+        data_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        if (in.bad())
+        {
+            throw Exception("Cannot map value file.");
+        }
+        size_t size = data_.size();
+        if (size > 0 && data_[size - 1] == '\n')
+        {
+            --size;
+            if (size > 0 && data_[size - 1] == '\r')
+            {
+                --size;
+            }
+        }
+        ref_ = StrRef(data_.data(), size);
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const StrRef &ref() const
+    {
+        return ref_;
+    }
+private:
+    Str data_;
+    StrRef ref_;
+};
+#endif
+
+inline void convert(const StrRef &value, Str &target)
+{
+    target.assign(value.data(), value.size());
+}
+
+inline void convert(const StrRef &value, bool &target)
+{
+    const StrRef &s = value;
+    if (s.empty() || s == "1" || s == "true" || s == "yes" || s == "on")
+    {
+        target = true;
+    }
+    else if (s == "0" || s == "false" || s == "no" || s == "off")
+    {
+        target = false;
+    }
+    else
+    {
+        throw Exception("Invalid parameter value.");
+    }
+}
+
+inline int hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/** Value of 8 decimal digits at p, or -1 if they are not all digits. */
+inline int64_t parse_8_digits(const char *p)
+{
+    uint64_t x;
+    std::memcpy(&x, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    x = __builtin_bswap64(x);
+#endif
+    // High nibbles must be 3 and low nibbles at most 9.
+    if (((x & 0xf0f0f0f0f0f0f0f0ULL)
+            | (((x + 0x0606060606060606ULL) & 0xf0f0f0f0f0f0f0f0ULL) >> 4))
+            != 0x3333333333333333ULL)
+    {
+        return -1;
+    }
+    x -= 0x3030303030303030ULL;
+    x = x * 10 + (x >> 8);
+    x = ((x & 0x000000ff000000ffULL) * (100 + (1000000ULL << 32))
+         + ((x >> 16) & 0x000000ff000000ffULL) * (1 + (10000ULL << 32))) >> 32;
+    return int64_t(x);
+}
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+/** Integer properties, including 128-bit types in strict standard mode. */
+template<typename T>
+struct IntegerTraits
+{
+    typedef typename std::make_unsigned<T>::type Unsigned;
+    static const bool is_signed = std::is_signed<T>::value;
+    /** Powers of ten up to 10^digits10 are representable. */
+    static const int digits10 = std::numeric_limits<T>::digits10;
+    static T max()
+    {
+        return std::numeric_limits<T>::max();
+    }
+};
+
+#ifdef __SIZEOF_INT128__
+template<>
+struct IntegerTraits<int128_t>
+{
+    typedef uint128_t Unsigned;
+    static const bool is_signed = true;
+    static const int digits10 = 38;
+    static int128_t max()
+    {
+        return int128_t((uint128_t(1) << 127) - 1);
+    }
+};
+
+template<>
+struct IntegerTraits<uint128_t>
+{
+    typedef uint128_t Unsigned;
+    static const bool is_signed = false;
+    static const int digits10 = 38;
+    static uint128_t max()
+    {
+        return ~uint128_t(0);
+    }
+};
+#endif
+
+/**
+ * Parse digits in given base into a magnitude not exceeding limit.
+ * Digits may be separated by single ' or _ characters.
+ */
+template<unsigned Base, typename U>
+U parse_magnitude(const char *p, const char *end, U limit)
+{
+    if (p == end)
+    {
+        throw Exception("Invalid parameter value.");
+    }
+    const U limit_div = limit / Base;
+    const unsigned limit_rem = unsigned(limit % Base);
+    // Limits for appending a chunk of 8 decimal digits.
+    const U chunk_div = Base == 10 ? U(limit / 100000000) : U(0);
+    const uint64_t chunk_rem = Base == 10 ? uint64_t(limit % 100000000) : 0;
+    U x = 0;
+    bool digit = false;
+    while (p < end)
+    {
+        if (Base == 10 && end - p >= 8)
+        {
+            int64_t chunk = parse_8_digits(p);
+            if (chunk >= 0)
+            {
+                if (x > chunk_div || (x == chunk_div && uint64_t(chunk) > chunk_rem))
+                {
+                    throw Exception("Parameter value out of range.");
+                }
+                x = U(x * U(100000000) + U(chunk));
+                p += 8;
+                digit = true;
+                continue;
+            }
+        }
+        char c = *p++;
+        if (digit && (c == '\'' || c == '_') && p < end)
+        {
+            digit = false;
+            continue;
+        }
+        int d = hex_value(c);
+        if (d < 0 || unsigned(d) >= Base)
+        {
+            throw Exception("Invalid parameter value.");
+        }
+        if (x > limit_div || (x == limit_div && unsigned(d) > limit_rem))
+        {
+            throw Exception("Parameter value out of range.");
+        }
+        x = U(x * Base + U(d));
+        digit = true;
+    }
+    return x;
+}
+
+/**
+ * Convert integer with optional sign, base prefix (0x, 0o, 0b, decimal
+ * otherwise) and digit separators (' or _).
+ */
+template<typename T>
+void convert_integer(const StrRef &value, T &target)
+{
+    typedef typename IntegerTraits<T>::Unsigned U;
+    const char *p = value.data();
+    const char *end = p + value.size();
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-'))
+    {
+        negative = *p == '-';
+        ++p;
+    }
+    if (negative && !IntegerTraits<T>::is_signed)
+    {
+        throw Exception("Parameter value out of range.");
+    }
+    const U limit = U(U(IntegerTraits<T>::max()) + (negative ? 1 : 0));
+    U x;
+    switch (end - p > 2 && p[0] == '0' ? p[1] | 0x20 : 0)
+    {
+    case 'x':
+        x = parse_magnitude<16>(p + 2, end, limit);
+        break;
+    case 'o':
+        x = parse_magnitude<8>(p + 2, end, limit);
+        break;
+    case 'b':
+        x = parse_magnitude<2>(p + 2, end, limit);
+        break;
+    default:
+        x = parse_magnitude<10>(p, end, limit);
+    }
+    target = negative && x > 0 ? T(-T(x - 1) - 1) : T(x);
+}
+
+/** Decimal digits of an integer. */
+template<typename T>
+Str format_integer(T value)
+{
+    typedef typename IntegerTraits<T>::Unsigned U;
+    bool negative = value < 0;
+    U x = negative ? U(~U(value) + 1) : U(value);
+    char buf[48];
+    char *p = buf + sizeof(buf);
+    do
+    {
+        *--p = char('0' + unsigned(x % 10));
+        x /= 10;
+    } while (x > 0);
+    if (negative)
+    {
+        *--p = '-';
+    }
+    return Str(p, buf + sizeof(buf));
+}
+
+inline void convert(const StrRef &value, int &target)
+{
+    convert_integer(value, target);
+}
+
+inline void convert(const StrRef &value, unsigned int &target)
+{
+    convert_integer(value, target);
+}
+
+inline void convert(const StrRef &value, long &target)
+{
+    convert_integer(value, target);
+}
+
+inline void convert(const StrRef &value, unsigned long &target)
+{
+    convert_integer(value, target);
+}
+
+inline void convert(const StrRef &value, long long &target)
+{
+    convert_integer(value, target);
+}
+
+inline void convert(const StrRef &value, unsigned long long &target)
+{
+    convert_integer(value, target);
+}
+
+#ifdef __SIZEOF_INT128__
+inline void convert(const StrRef &value, int128_t &target)
+{
+    convert_integer(value, target);
+}
+
+inline void convert(const StrRef &value, uint128_t &target)
+{
+    convert_integer(value, target);
+}
+#endif
+
+/** Rounding of decimal values with more fractional digits than the scale. */
+enum class Rounding
+{
+    Exact,      // Reject values which cannot be represented exactly.
+    Down,       // Toward zero.
+    HalfUp,     // To nearest, ties away from zero.
+    HalfEven    // To nearest, ties to even.
+};
+
+/**
+ * Fixed-point decimal number stored as an integer multiple of 10^-Scale,
+ * e.g., Decimal<2> for monetary values in cents.
+ */
+template<unsigned Scale, typename Rep = int64_t, Rounding Round = Rounding::HalfEven>
+class Decimal
+{
+    static_assert(Scale <= unsigned(IntegerTraits<Rep>::digits10),
+                  "Decimal scale too large for its representation.");
+public:
+    typedef typename IntegerTraits<Rep>::Unsigned Unsigned;
+    static const unsigned scale = Scale;
+    static const Rounding rounding = Round;
+
+    Decimal():
+            raw_(0)
+    {}
+    static Decimal from_raw(Rep raw)
+    {
+        Decimal d;
+        d.raw_ = raw;
+        return d;
+    }
+    /** 10^Scale */
+    static Unsigned unit()
+    {
+        Unsigned u = 1;
+        for (unsigned i = 0; i < Scale; ++i)
+        {
+            u *= 10;
+        }
+        return u;
+    }
+    Rep raw() const
+    {
+        return raw_;
+    }
+    Str str() const
+    {
+        Unsigned x = raw_ < 0 ? Unsigned(~Unsigned(raw_) + 1) : Unsigned(raw_);
+        Str s = format_integer(x / unit());
+        if (Scale > 0)
+        {
+            Str frac = format_integer(x % unit());
+            s += '.' + Str(Scale - frac.size(), '0') + frac;
+        }
+        return raw_ < 0 ? '-' + s : s;
+    }
+    bool operator==(const Decimal &other) const
+    {
+        return raw_ == other.raw_;
+    }
+    bool operator!=(const Decimal &other) const
+    {
+        return raw_ != other.raw_;
+    }
+    bool operator<(const Decimal &other) const
+    {
+        return raw_ < other.raw_;
+    }
+    bool operator>(const Decimal &other) const
+    {
+        return raw_ > other.raw_;
+    }
+    bool operator<=(const Decimal &other) const
+    {
+        return raw_ <= other.raw_;
+    }
+    bool operator>=(const Decimal &other) const
+    {
+        return raw_ >= other.raw_;
+    }
+private:
+    Rep raw_;
+};
+
+/**
+ * Parse decimal number with optional sign, integer digits (with separators)
+ * and fractional digits into a multiple of 10^-scale, without floating-point
+ * arithmetic.
+ */
+template<typename Rep>
+Rep parse_decimal(const StrRef &value, unsigned scale, Rounding rounding)
+{
+    typedef typename IntegerTraits<Rep>::Unsigned U;
+    U unit = 1;
+    for (unsigned i = 0; i < scale; ++i)
+    {
+        unit = U(unit * 10);
+    }
+    const char *p = value.data();
+    const char *end = p + value.size();
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-'))
+    {
+        negative = *p == '-';
+        ++p;
+    }
+    if (negative && !IntegerTraits<Rep>::is_signed)
+    {
+        throw Exception("Parameter value out of range.");
+    }
+    const U limit = U(U(IntegerTraits<Rep>::max()) + (negative ? 1 : 0));
+    const char *dot = p;
+    while (dot < end && *dot != '.')
+    {
+        ++dot;
+    }
+    if (dot == p && (dot == end || dot + 1 == end))
+    {
+        throw Exception("Invalid parameter value.");
+    }
+    // Integer part, possibly empty as in .5.
+    U x = dot > p ? parse_magnitude<10>(p, dot, U(limit / unit)) : U(0);
+    // Kept fractional digits, padded with zeros.
+    const char *q = dot < end ? dot + 1 : end;
+    U frac = 0;
+    for (unsigned i = 0; i < scale; ++i)
+    {
+        unsigned d = 0;
+        if (q < end)
+        {
+            d = unsigned(*q++ - '0');
+            if (d > 9)
+            {
+                throw Exception("Invalid parameter value.");
+            }
+        }
+        frac = U(frac * 10 + d);
+    }
+    // First dropped digit and whether any further digit is non-zero.
+    unsigned first = 0;
+    bool rest = false;
+    for (const char *r = q; r < end; ++r)
+    {
+        unsigned d = unsigned(*r - '0');
+        if (d > 9)
+        {
+            throw Exception("Invalid parameter value.");
+        }
+        if (r == q)
+        {
+            first = d;
+        }
+        else
+        {
+            rest = rest || d > 0;
+        }
+    }
+    if (x == U(limit / unit) && frac > U(limit % unit))
+    {
+        throw Exception("Parameter value out of range.");
+    }
+    x = U(x * unit + frac);
+    bool up = false;
+    switch (rounding)
+    {
+    case Rounding::Exact:
+        if (first > 0 || rest)
+        {
+            throw Exception("Inexact decimal value.");
+        }
+        break;
+    case Rounding::Down:
+        break;
+    case Rounding::HalfUp:
+        up = first >= 5;
+        break;
+    case Rounding::HalfEven:
+        up = first > 5 || (first == 5 && (rest || x % 2 == 1));
+        break;
+    }
+    if (up)
+    {
+        if (x == limit)
+        {
+            throw Exception("Parameter value out of range.");
+        }
+        ++x;
+    }
+    return negative && x > 0 ? Rep(-Rep(x - 1) - 1) : Rep(x);
+}
+
+template<unsigned Scale, typename Rep, Rounding Round>
+void convert(const StrRef &value, Decimal<Scale, Rep, Round> &target)
+{
+    target = Decimal<Scale, Rep, Round>::from_raw(parse_decimal<Rep>(value, Scale, Round));
+}
+
+template<typename T, typename F>
+void convert_float(const StrRef &value, T &target, F func)
+{
+    // Views need not be null-terminated, use a local copy, on the heap if long.
+    char local[64];
+    std::unique_ptr<char[]> heap;
+    char *buf = local;
+    if (value.empty())
+    {
+        throw Exception("Invalid parameter value.");
+    }
+    if (value.size() >= sizeof(local))
+    {
+        heap.reset(new char[value.size() + 1]);
+        buf = heap.get();
+    }
+    std::memcpy(buf, value.data(), value.size());
+    buf[value.size()] = '\0';
+    char *end = nullptr;
+    errno = 0;
+    T x = func(buf, &end);
+    if (end != buf + value.size())
+    {
+        throw Exception("Invalid parameter value.");
+    }
+    if (errno == ERANGE)
+    {
+        throw Exception("Parameter value out of range.");
+    }
+    target = x;
+}
+
+inline void convert(const StrRef &value, float &target)
+{
+    convert_float(value, target, std::strtof);
+}
+
+inline void convert(const StrRef &value, double &target)
+{
+    convert_float(value, target, std::strtod);
+}
+
+/** Text encoding of binary (blob) parameter values. */
+enum class Encoding
+{
+    Base64,
+    Hex
+};
+
+inline int base64_value(char c)
+{
+    if (c >= 'A' && c <= 'Z')
+    {
+        return c - 'A';
+    }
+    if (c >= 'a' && c <= 'z')
+    {
+        return c - 'a' + 26;
+    }
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0' + 52;
+    }
+    if (c == '+')
+    {
+        return 62;
+    }
+    if (c == '/')
+    {
+        return 63;
+    }
+    return -1;
+}
+
+/** Number of bytes encoded in the hex string. */
+inline size_t hex_size(const StrRef &value)
+{
+    if (value.size() % 2 != 0)
+    {
+        throw Exception("Invalid blob length.");
+    }
+    return value.size() / 2;
+}
+
+/** Number of bytes encoded in the (optionally padded) base64 string. */
+inline size_t base64_size(const StrRef &value)
+{
+    size_t n = value.size();
+    if (n % 4 == 0)
+    {
+        for (int i = 0; i < 2 && n > 0 && value[n - 1] == '='; ++i)
+        {
+            --n;
+        }
+    }
+    if (n % 4 == 1)
+    {
+        throw Exception("Invalid blob length.");
+    }
+    return n / 4 * 3 + (n % 4 == 0 ? 0 : n % 4 - 1);
+}
+
+/** Decode hex string of 2 * n characters into n bytes. */
+inline bool decode_hex(const char *src, size_t n, uint8_t *dst)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    // 16 characters to 8 bytes per iteration.
+    const __m128i digit_lo = _mm_set1_epi8('0' - 1);
+    const __m128i digit_hi = _mm_set1_epi8('9' + 1);
+    const __m128i alpha_lo = _mm_set1_epi8('a' - 1);
+    const __m128i alpha_hi = _mm_set1_epi8('f' + 1);
+    const __m128i lower = _mm_set1_epi8(0x20);
+    const __m128i low_byte = _mm_set1_epi16(0x00ff);
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * i));
+        __m128i l = _mm_or_si128(v, lower);
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, digit_lo),
+                                      _mm_cmplt_epi8(v, digit_hi));
+        __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(l, alpha_lo),
+                                      _mm_cmplt_epi8(l, alpha_hi));
+        if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xffff)
+        {
+            return false;
+        }
+        __m128i nibbles = _mm_or_si128(
+                _mm_and_si128(digit, _mm_sub_epi8(v, _mm_set1_epi8('0'))),
+                _mm_and_si128(alpha, _mm_sub_epi8(l, _mm_set1_epi8('a' - 10))));
+        __m128i bytes = _mm_or_si128(
+                _mm_slli_epi16(_mm_and_si128(nibbles, low_byte), 4),
+                _mm_srli_epi16(nibbles, 8));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + i),
+                         _mm_packus_epi16(bytes, bytes));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        int hi = hex_value(src[2 * i]);
+        int lo = hex_value(src[2 * i + 1]);
+        if (hi < 0 || lo < 0)
+        {
+            return false;
+        }
+        dst[i] = uint8_t(hi << 4 | lo);
+    }
+    return true;
+}
+
+/** Decode base64 string into n bytes, n from base64_size. */
+inline bool decode_base64(const char *src, size_t n, uint8_t *dst)
+{
+    size_t i = 0;
+    const char *s = src;
+#ifdef __SSE2__
+    // 16 characters to 12 bytes per iteration.
+    const __m128i upper_lo = _mm_set1_epi8('A' - 1);
+    const __m128i upper_hi = _mm_set1_epi8('Z' + 1);
+    const __m128i lower_lo = _mm_set1_epi8('a' - 1);
+    const __m128i lower_hi = _mm_set1_epi8('z' + 1);
+    const __m128i digit_lo = _mm_set1_epi8('0' - 1);
+    const __m128i digit_hi = _mm_set1_epi8('9' + 1);
+    for (; i + 12 <= n; i += 12, s += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, upper_lo),
+                                      _mm_cmplt_epi8(v, upper_hi));
+        __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(v, lower_lo),
+                                      _mm_cmplt_epi8(v, lower_hi));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, digit_lo),
+                                      _mm_cmplt_epi8(v, digit_hi));
+        __m128i plus = _mm_cmpeq_epi8(v, _mm_set1_epi8('+'));
+        __m128i slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+        __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                                     _mm_or_si128(digit, _mm_or_si128(plus, slash)));
+        if (_mm_movemask_epi8(valid) != 0xffff)
+        {
+            return false;
+        }
+        // Offset to add to each character to get its 6-bit value.
+        __m128i offset = _mm_or_si128(
+                _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                             _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+                _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                             _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(62 - '+')),
+                                          _mm_and_si128(slash, _mm_set1_epi8(63 - '/')))));
+        __m128i sextets = _mm_add_epi8(v, offset);
+        // Merge sextet pairs into 12-bit and then quads into 24-bit values.
+        __m128i pairs = _mm_or_si128(
+                _mm_slli_epi16(_mm_and_si128(sextets, _mm_set1_epi16(0x00ff)), 6),
+                _mm_srli_epi16(sextets, 8));
+        __m128i quads = _mm_or_si128(
+                _mm_slli_epi32(_mm_and_si128(pairs, _mm_set1_epi32(0x0000ffff)), 12),
+                _mm_srli_epi32(pairs, 16));
+        uint32_t q[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(q), quads);
+        for (int k = 0; k < 4; ++k)
+        {
+            dst[i + 3 * k] = uint8_t(q[k] >> 16);
+            dst[i + 3 * k + 1] = uint8_t(q[k] >> 8);
+            dst[i + 3 * k + 2] = uint8_t(q[k]);
+        }
+    }
+#endif
+    for (; i < n; i += 3, s += 4)
+    {
+        // Last group may be shorter (2 or 3 characters for 1 or 2 bytes).
+        size_t m = std::min<size_t>(3, n - i);
+        uint32_t quad = 0;
+        for (size_t k = 0; k < 4; ++k)
+        {
+            int x = k <= m ? base64_value(s[k]) : 0;
+            if (x < 0)
+            {
+                return false;
+            }
+            quad = quad << 6 | uint32_t(x);
+        }
+        for (size_t k = 0; k < m; ++k)
+        {
+            dst[i + k] = uint8_t(quad >> (16 - 8 * k));
+        }
+    }
+    return true;
+}
+
+/** Decode the value into n bytes at dst, n given by blob_size. */
+inline void decode(const StrRef &value, Encoding encoding, uint8_t *dst, size_t n)
+{
+    bool ok = encoding == Encoding::Hex
+              ? decode_hex(value.data(), n, dst)
+              : decode_base64(value.data(), n, dst);
+    if (!ok)
+    {
+        throw Exception("Invalid blob value.");
+    }
+}
+
+inline size_t blob_size(const StrRef &value, Encoding encoding)
+{
+    return encoding == Encoding::Hex ? hex_size(value) : base64_size(value);
+}
+
+/** Validate one UTF-8 sequence starting with a non-ASCII byte, return its end or null. */
+inline const uint8_t *utf8_sequence(const uint8_t *p, const uint8_t *end)
+{
+    // Allowed range of the second byte depends on the first (Unicode table 3-7),
+    // further bytes are 80..BF.
+    uint8_t c = p[0], lo = 0x80, hi = 0xBF;
+    size_t n;
+    if (c >= 0xC2 && c <= 0xDF)
+    {
+        n = 2;
+    }
+    else if (c >= 0xE0 && c <= 0xEF)
+    {
+        n = 3;
+        lo = c == 0xE0 ? 0xA0 : 0x80;
+        hi = c == 0xED ? 0x9F : 0xBF;
+    }
+    else if (c >= 0xF0 && c <= 0xF4)
+    {
+        n = 4;
+        lo = c == 0xF0 ? 0x90 : 0x80;
+        hi = c == 0xF4 ? 0x8F : 0xBF;
+    }
+    else
+    {
+        return nullptr;
+    }
+    if (size_t(end - p) < n || p[1] < lo || p[1] > hi)
+    {
+        return nullptr;
+    }
+    for (size_t i = 2; i < n; ++i)
+    {
+        if ((p[i] & 0xC0) != 0x80)
+        {
+            return nullptr;
+        }
+    }
+    return p + n;
+}
+
+#ifdef __SSSE3__
+/**
+ * Validate UTF-8 in blocks of 16 bytes by lookups of nibbles of each byte
+ * and its predecessor (Keiser and Lemire, Validating UTF-8 in less than one
+ * instruction per byte), accumulating errors.
+ */
+class Utf8Blocks
+{
+public:
+    Utf8Blocks():
+            prev_(_mm_setzero_si128()), incomplete_(_mm_setzero_si128()),
+            error_(_mm_setzero_si128())
+    {}
+
+    void add(__m128i in)
+    {
+        if (_mm_movemask_epi8(in) == 0)
+        {
+            // ASCII block, sequences of the previous one must be complete.
+            error_ = _mm_or_si128(error_, incomplete_);
+            incomplete_ = _mm_setzero_si128();
+            prev_ = in;
+            return;
+        }
+        const __m128i low = _mm_set1_epi8(0x0F);
+        __m128i prev1 = _mm_alignr_epi8(in, prev_, 15);
+        __m128i special = _mm_and_si128(
+                _mm_and_si128(lookup(_mm_and_si128(_mm_srli_epi16(prev1, 4), low), byte_1_high()),
+                              lookup(_mm_and_si128(prev1, low), byte_1_low())),
+                lookup(_mm_and_si128(_mm_srli_epi16(in, 4), low), byte_2_high()));
+        // Third and fourth bytes of sequences must be continuations, the
+        // tables above flag them as two continuations.
+        __m128i prev2 = _mm_alignr_epi8(in, prev_, 14);
+        __m128i prev3 = _mm_alignr_epi8(in, prev_, 13);
+        __m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(char(0xE0 - 0x80))),
+                                      _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xF0 - 0x80))));
+        __m128i must23_80 = _mm_and_si128(must23, _mm_set1_epi8(char(0x80)));
+        error_ = _mm_or_si128(error_, _mm_xor_si128(must23_80, special));
+        // Leads in the last three bytes need continuations in the next block.
+        incomplete_ = _mm_subs_epu8(in, _mm_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1)));
+        prev_ = in;
+    }
+    /** Valid if all blocks were, and the last ended with complete sequences. */
+    bool valid() const
+    {
+        __m128i e = _mm_or_si128(error_, incomplete_);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(e, _mm_setzero_si128())) == 0xFFFF;
+    }
+private:
+    enum: uint8_t
+    {
+        TooShort = 1 << 0,      // Lead not followed by continuation.
+        TooLong = 1 << 1,       // ASCII followed by continuation.
+        Overlong3 = 1 << 2,
+        TooLarge = 1 << 3,
+        Surrogate = 1 << 4,
+        Overlong2 = 1 << 5,
+        TooLarge1000 = 1 << 6,
+        Overlong4 = 1 << 6,
+        TwoConts = 1 << 7,      // Continuation followed by continuation.
+        Carry = TooShort | TooLong | TwoConts
+    };
+
+    static __m128i lookup(__m128i nibbles, __m128i table)
+    {
+        return _mm_shuffle_epi8(table, nibbles);
+    }
+    static __m128i byte_1_high()
+    {
+        return _mm_setr_epi8(
+                TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+                char(TwoConts), char(TwoConts), char(TwoConts), char(TwoConts),
+                TooShort | Overlong2,
+                TooShort,
+                TooShort | Overlong3 | Surrogate,
+                TooShort | TooLarge | TooLarge1000 | Overlong4);
+    }
+    static __m128i byte_1_low()
+    {
+        return _mm_setr_epi8(
+                char(Carry | Overlong3 | Overlong2 | Overlong4),
+                char(Carry | Overlong2),
+                char(Carry),
+                char(Carry),
+                char(Carry | TooLarge),
+                char(Carry | TooLarge | TooLarge1000),
+                char(Carry | TooLarge | TooLarge1000),
+                char(Carry | TooLarge | TooLarge1000),
+                char(Carry | TooLarge | TooLarge1000),
+                char(Carry | TooLarge | TooLarge1000),
+                char(Carry | TooLarge | TooLarge1000),
+                char(Carry | TooLarge | TooLarge1000),
+                char(Carry | TooLarge | TooLarge1000),
+                char(Carry | TooLarge | TooLarge1000 | Surrogate),
+                char(Carry | TooLarge | TooLarge1000),
+                char(Carry | TooLarge | TooLarge1000));
+    }
+    static __m128i byte_2_high()
+    {
+        return _mm_setr_epi8(
+                TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+                char(TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge1000 | Overlong4),
+                char(TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge),
+                char(TooLong | Overlong2 | TwoConts | Surrogate | TooLarge),
+                char(TooLong | Overlong2 | TwoConts | Surrogate | TooLarge),
+                TooShort, TooShort, TooShort, TooShort);
+    }
+
+    __m128i prev_;
+    __m128i incomplete_;
+    __m128i error_;
+};
+#endif
+
+/**
+ * Is the value valid UTF-8 (no overlong forms, surrogates or code points
+ * above U+10FFFF)? With SSSE3, all blocks of 16 bytes are validated by
+ * table lookups. Otherwise, ASCII blocks are skipped with SSE2 and other
+ * bytes are validated by sequence, in a single pass.
+ */
+inline bool is_utf8(const char *data, size_t size)
+{
+#ifdef __SSSE3__
+    Utf8Blocks blocks;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        blocks.add(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+    }
+    if (i < size)
+    {
+        // Zero padding is ASCII, which flags sequences cut by the end.
+        char tail[16] = {};
+        std::memcpy(tail, data + i, size - i);
+        blocks.add(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tail)));
+    }
+    return blocks.valid();
+#else
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(data);
+    const uint8_t *end = p + size;
+    while (p < end)
+    {
+#ifdef __SSE2__
+        while (end - p >= 16
+               && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))) == 0)
+        {
+            p += 16;
+        }
+#endif
+        // Validate up to a block, sequences may cross its end.
+        const uint8_t *block_end = p + std::min<size_t>(16, size_t(end - p));
+        while (p < block_end)
+        {
+            if (*p < 0x80)
+            {
+                ++p;
+                continue;
+            }
+            p = utf8_sequence(p, end);
+            if (!p)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+#endif
+}
+
+template<typename T>
+void convert(const StrRef &value, T &target, Encoding)
+{
+    convert(value, target);
+}
+
+inline void convert(const StrRef &value, std::vector<uint8_t> &target, Encoding encoding)
+{
+    size_t n = blob_size(value, encoding);
+    target.resize(n);
+    decode(value, encoding, target.data(), n);
+}
+
+template<size_t N>
+void convert(const StrRef &value, std::array<uint8_t, N> &target, Encoding encoding)
+{
+    if (blob_size(value, encoding) != N)
+    {
+        throw Exception("Invalid blob length.");
+    }
+    decode(value, encoding, target.data(), N);
+}
+
+/** Kind of a parameter value, e.g., for schema export. */
+enum class ValueType: uint8_t
+{
+    Other,
+    Bool,
+    String,
+    Integer,
+    Float,
+    Blob,
+    Decimal
+};
+
+/** Description of a parameter value type. */
+struct TypeInfo
+{
+    ValueType type;
+    bool is_signed;
+    uint32_t bits;      // Width of integer, float or decimal representation.
+    uint32_t extra;     // Blob length (0 if variable) or decimal scale.
+    Rounding rounding;  // Decimal rounding.
 };
 
-bool is_option(const std::string &arg)
+template<typename T>
+TypeInfo type_info(const T *)
+{
+    return TypeInfo{ValueType::Other, false, 0, 0, Rounding::Exact};
+}
+
+template<typename T>
+TypeInfo integer_type_info()
+{
+    return TypeInfo{ValueType::Integer, IntegerTraits<T>::is_signed,
+                    uint32_t(8 * sizeof(T)), 0, Rounding::Exact};
+}
+
+inline TypeInfo type_info(const bool *)
+{
+    return TypeInfo{ValueType::Bool, false, 0, 0, Rounding::Exact};
+}
+
+inline TypeInfo type_info(const Str *)
+{
+    return TypeInfo{ValueType::String, false, 0, 0, Rounding::Exact};
+}
+
+inline TypeInfo type_info(const int *)
+{
+    return integer_type_info<int>();
+}
+
+inline TypeInfo type_info(const unsigned int *)
+{
+    return integer_type_info<unsigned int>();
+}
+
+inline TypeInfo type_info(const long *)
+{
+    return integer_type_info<long>();
+}
+
+inline TypeInfo type_info(const unsigned long *)
+{
+    return integer_type_info<unsigned long>();
+}
+
+inline TypeInfo type_info(const long long *)
+{
+    return integer_type_info<long long>();
+}
+
+inline TypeInfo type_info(const unsigned long long *)
+{
+    return integer_type_info<unsigned long long>();
+}
+
+#ifdef __SIZEOF_INT128__
+inline TypeInfo type_info(const int128_t *)
+{
+    return integer_type_info<int128_t>();
+}
+
+inline TypeInfo type_info(const uint128_t *)
+{
+    return integer_type_info<uint128_t>();
+}
+#endif
+
+inline TypeInfo type_info(const float *)
+{
+    return TypeInfo{ValueType::Float, true, 32, 0, Rounding::Exact};
+}
+
+inline TypeInfo type_info(const double *)
+{
+    return TypeInfo{ValueType::Float, true, 64, 0, Rounding::Exact};
+}
+
+inline TypeInfo type_info(const std::vector<uint8_t> *)
+{
+    return TypeInfo{ValueType::Blob, false, 0, 0, Rounding::Exact};
+}
+
+template<size_t N>
+TypeInfo type_info(const std::array<uint8_t, N> *)
+{
+    return TypeInfo{ValueType::Blob, false, 0, uint32_t(N), Rounding::Exact};
+}
+
+template<unsigned Scale, typename Rep, Rounding Round>
+TypeInfo type_info(const Decimal<Scale, Rep, Round> *)
+{
+    return TypeInfo{ValueType::Decimal, IntegerTraits<Rep>::is_signed,
+                    uint32_t(8 * sizeof(Rep)), Scale, Round};
+}
+
+inline Str encode_hex(const uint8_t *data, size_t n)
+{
+    static const char digits[] = "0123456789abcdef";
+    Str s(2 * n, '\0');
+    for (size_t i = 0; i < n; ++i)
+    {
+        s[2 * i] = digits[data[i] >> 4];
+        s[2 * i + 1] = digits[data[i] & 15];
+    }
+    return s;
+}
+
+inline Str encode_base64(const uint8_t *data, size_t n)
+{
+    static const char digits[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    Str s;
+    s.reserve((n + 2) / 3 * 4);
+    for (size_t i = 0; i < n; i += 3)
+    {
+        uint32_t quad = uint32_t(data[i]) << 16
+                        | (i + 1 < n ? uint32_t(data[i + 1]) << 8 : 0)
+                        | (i + 2 < n ? uint32_t(data[i + 2]) : 0);
+        for (size_t k = 0; k < 4; ++k)
+        {
+            s += k <= n - i ? digits[(quad >> (18 - 6 * k)) & 63] : '=';
+        }
+    }
+    return s;
+}
+
+/** Format value as text accepted by convert, empty if not supported. */
+template<typename T>
+Str format(const T &, Encoding)
+{
+    return Str();
+}
+
+inline Str format(const bool &value, Encoding)
+{
+    return value ? "true" : "false";
+}
+
+inline Str format(const Str &value, Encoding)
+{
+    return value;
+}
+
+inline Str format(const int &value, Encoding)
+{
+    return format_integer(value);
+}
+
+inline Str format(const unsigned int &value, Encoding)
+{
+    return format_integer(value);
+}
+
+inline Str format(const long &value, Encoding)
+{
+    return format_integer(value);
+}
+
+inline Str format(const unsigned long &value, Encoding)
+{
+    return format_integer(value);
+}
+
+inline Str format(const long long &value, Encoding)
+{
+    return format_integer(value);
+}
+
+inline Str format(const unsigned long long &value, Encoding)
 {
-    return arg.size() > 0 && arg[0] == '-';
+    return format_integer(value);
 }
 
-typedef std::string Str;
-typedef std::vector<Str> StrVec;
-typedef std::initializer_list<Str> StrInit;
+#ifdef __SIZEOF_INT128__
+inline Str format(const int128_t &value, Encoding)
+{
+    return format_integer(value);
+}
+
+inline Str format(const uint128_t &value, Encoding)
+{
+    return format_integer(value);
+}
+#endif
+
+inline Str format(const float &value, Encoding)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", double(value));
+    return buf;
+}
+
+inline Str format(const double &value, Encoding)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", value);
+    return buf;
+}
+
+inline Str format(const std::vector<uint8_t> &value, Encoding encoding)
+{
+    return encoding == Encoding::Hex
+           ? encode_hex(value.data(), value.size())
+           : encode_base64(value.data(), value.size());
+}
+
+template<size_t N>
+Str format(const std::array<uint8_t, N> &value, Encoding encoding)
+{
+    return encoding == Encoding::Hex
+           ? encode_hex(value.data(), N)
+           : encode_base64(value.data(), N);
+}
+
+template<unsigned Scale, typename Rep, Rounding Round>
+Str format(const Decimal<Scale, Rep, Round> &value, Encoding)
+{
+    return value.str();
+}
+
+/** Kind of a declared value constraint. */
+enum class ConstraintKind: uint8_t
+{
+    Range,
+    Positive,
+    PowerOfTwo,
+    Pattern,
+    Custom,
+    Utf8
+};
+
+/** Declarative description of a value constraint, e.g., for schema export. */
+struct Constraint
+{
+    ConstraintKind kind;
+    Str first;      // Range minimum, pattern or custom message.
+    Str second;     // Range maximum.
+};
+
+#ifdef PROGRAM_PARAMS_COUNTERS
+/** Relaxed atomic counter, copyable so that parameters can be stored in containers. */
+class Counter
+{
+public:
+    Counter():
+            n_(0)
+    {}
+    Counter(const Counter &other):
+            n_(other.value())
+    {}
+    void increment()
+    {
+        n_.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t value() const
+    {
+        return n_.load(std::memory_order_relaxed);
+    }
+private:
+    std::atomic<uint64_t> n_;
+};
+#endif
+
+#ifdef PROGRAM_PARAMS_HISTOGRAMS
+/**
+ * Lock-free histogram of durations in ns, in log-spaced buckets: 8 buckets
+ * per power of two, so values are recorded with 12.5% precision.
+ */
+class Histogram
+{
+public:
+    static const size_t sub_bits = 3;
+    static const size_t sub = size_t(1) << sub_bits;
+    static const size_t size = (64 - sub_bits + 1) * sub;
+
+    Histogram():
+            count_(0), max_(0)
+    {
+        for (auto &b: buckets_)
+        {
+            b.store(0, std::memory_order_relaxed);
+        }
+    }
+    static size_t index(uint64_t v)
+    {
+        if (v < sub)
+        {
+            return size_t(v);
+        }
+        size_t e = size_t(63 - __builtin_clzll(v));
+        return (e - sub_bits + 1) * sub + size_t((v >> (e - sub_bits)) & (sub - 1));
+    }
+    /** Smallest value recorded in bucket i. */
+    static uint64_t lower(size_t i)
+    {
+        if (i < sub)
+        {
+            return i;
+        }
+        size_t e = i / sub + sub_bits - 1;
+        return uint64_t(sub + i % sub) << (e - sub_bits);
+    }
+    void record(uint64_t ns)
+    {
+        buckets_[index(ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        while (ns > max && !max_.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+        {}
+    }
+    uint64_t count() const
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+    uint64_t max() const
+    {
+        return max_.load(std::memory_order_relaxed);
+    }
+    /** Upper bound of the bucket holding quantile q (0 to 1). */
+    uint64_t quantile(double q) const
+    {
+        uint64_t n = count();
+        uint64_t rank = uint64_t(q * double(n));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen > rank)
+            {
+                return std::min(i + 1 < size ? lower(i + 1) - 1 : max(), max());
+            }
+        }
+        return max();
+    }
+private:
+    std::atomic<uint64_t> buckets_[size];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> max_;
+};
+
+/** Latency histograms of parsing phases of a Params instance. */
+struct Latency
+{
+    Histogram parse;        // Whole parse calls.
+    Histogram convert;      // Conversion of single values.
+    Histogram validate;     // Checks of single values.
+
+    typedef std::chrono::steady_clock Clock;
+
+    static uint64_t since(Clock::time_point start)
+    {
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - start).count());
+    }
+
+    /** Text table of counts and quantiles in ns. */
+    Str str() const
+    {
+        Str s("phase          count      p50      p90      p99    p99.9      max\n");
+        const Histogram *phases[] = {&parse, &convert, &validate};
+        const char *names[] = {"parse", "convert", "validate"};
+        for (size_t i = 0; i < 3; ++i)
+        {
+            const Histogram &h = *phases[i];
+            char line[128];
+            std::snprintf(line, sizeof(line), "%-8s %11llu %8llu %8llu %8llu %8llu %8llu\n",
+                          names[i], (unsigned long long) h.count(),
+                          (unsigned long long) h.quantile(0.5),
+                          (unsigned long long) h.quantile(0.9),
+                          (unsigned long long) h.quantile(0.99),
+                          (unsigned long long) h.quantile(0.999),
+                          (unsigned long long) h.max());
+            s += line;
+        }
+        return s;
+    }
+};
+#endif
+
+class Params;
 
 class ParamBase
 {
 public:
     typedef std::shared_ptr<ParamBase> Ptr;
 
-    ParamBase(const StrVec &names, bool required):
-            names_(names), required_(required)
+    ParamBase(StrVec names, bool required):
+            names_(std::move(names)), option_(false), required_(required), found_(false),
+            file_values_(false), encoding_(Encoding::Base64), interpolate_(false),
+            pending_(Pending::None), version_(0)
     {
         auto first = true;
-        for (auto name: names)
+        for (const auto &name: names_)
         {
             auto option = is_option(name);
             assert(first || option == option_);
@@ -59,36 +1811,111 @@ public:
         }
     }
 
-    virtual int parse(char **start, char **end) = 0;
+    /** Does the parameter go without a value when given as an option? */
+    virtual bool flag() const = 0;
 
-    std::string value(char **start, char **end, int &inc) const
+    /** Convert the value and store it in the target. */
+    virtual void parse(const StrRef &value) = 0;
+
+    /**
+     * Parse the value given on the command line, reading it from a file
+     * if it is in the form @path and value files are enabled.
+     * Use @@ for a literal value starting with @.
+     */
+    void set(const StrRef &value)
     {
-        assert(start < end);
-        std::string opt(start[0]);
-        if (!option_)
-        {
-            // Positional, we can directly return the value.
-            inc = 1;
-            return opt;
-        }
-        // An option, possibly combined with value in the same token.
-        auto i = opt.find('=');
-        if (i != std::string::npos)
-        {
-            // Long option with equals delimiter.
-            inc = 1;
-            return opt.substr(i + 1);
-        }
-        if (opt.size() > 2)
+        if (file_values_ && value.size() > 1 && value[0] == '@')
         {
-            // Short option with appended value.
-            inc = 1;
-            return opt.substr(2);
+            if (value[1] == '@')
+            {
+                accept(value.substr(1));
+                return;
+            }
+            MappedFile file(value.substr(1).str());
+            accept(file.ref());
+            return;
         }
-        // Value as a separate token.
-        assert(start + 1 < end);
-        inc = 2;
-        return std::string(start[1]);
+        accept(value);
+    }
+
+    /** Value type of the target. */
+    virtual TypeInfo type() const = 0;
+
+    /** Current value of the target as text, empty if not supported. */
+    virtual Str str() const = 0;
+
+    /** Name for messages, the first name given. */
+    Str name() const
+    {
+        return names_.empty() ? Str("positional") : names_.front();
+    }
+    const StrVec &names() const
+    {
+        return names_;
+    }
+    bool option() const
+    {
+        return option_;
+    }
+    bool required() const
+    {
+        return required_;
+    }
+    bool found() const
+    {
+        return found_;
+    }
+    /** Incremented whenever the value is parsed or set, e.g., to invalidate derived values. */
+    uint64_t version() const
+    {
+        return version_;
+    }
+    bool file_values() const
+    {
+        return file_values_;
+    }
+    Encoding encoding() const
+    {
+        return encoding_;
+    }
+    const Str &help() const
+    {
+        return help_;
+    }
+    const std::vector<Constraint> &constraints() const
+    {
+        return constraints_;
+    }
+
+    bool interpolate() const
+    {
+        return interpolate_;
+    }
+#ifdef PROGRAM_PARAMS_COUNTERS
+    /**
+     * Number of reads by Params::get, Param::value or StaticParams::get.
+     * Reads of external targets directly cannot be counted.
+     */
+    uint64_t reads() const
+    {
+        return reads_.value();
+    }
+    /** Count a read of the value. */
+    void count_read() const
+    {
+        reads_.increment();
+    }
+    /** Number of parses (or sets) which found the parameter. */
+    uint64_t sets() const
+    {
+        return sets_.value();
+    }
+#endif
+
+    void reset()
+    {
+        found_ = false;
+        pending_ = Pending::None;
     }
 
     void check() const
@@ -103,109 +1930,516 @@ protected:
     bool option_;
     bool required_;
     bool found_;
+    bool file_values_;
+    Encoding encoding_;
+    Str help_;
+    std::vector<Constraint> constraints_;
+
+    /** State of a value kept as text until interpolated by Params. */
+    enum class Pending: uint8_t
+    {
+        None,
+        Text,
+        Resolving
+    };
+    bool interpolate_;
+    Pending pending_;
+    /** Value with ${name} references, interpolated in place when resolved. */
+    Str text_;
+    /** Params holding the target, which interpolate it when read, null for external targets. */
+    const Params *owner_ = nullptr;
+    uint64_t version_;
+#ifdef PROGRAM_PARAMS_COUNTERS
+    mutable Counter reads_;
+    Counter sets_;
+#endif
+#ifdef PROGRAM_PARAMS_HISTOGRAMS
+    /** Histograms of the owning Params. */
+    Latency *latency_ = nullptr;
+#endif
+
+    void mark_found()
+    {
+        ++version_;
+#ifdef PROGRAM_PARAMS_COUNTERS
+        if (!found_)
+        {
+            sets_.increment();
+        }
+#endif
+        found_ = true;
+    }
+    /** Interpolate a value kept as text, if the target is held by Params. */
+    void resolve_pending() const;
+private:
+    friend class Params;
+
+    /** Parse the value, or keep it as text if it has references to interpolate. */
+    void accept(const StrRef &value)
+    {
+        if (interpolate_ && value.find('$') != StrRef::npos)
+        {
+            text_.assign(value.data(), value.size());
+            pending_ = Pending::Text;
+            mark_found();
+            return;
+        }
+        pending_ = Pending::None;
+        parse(value);
+    }
 };
 
 template<typename T>
 class Param: public ParamBase
 {
 public:
-    Param(T &target, const StrVec &names, bool replace):
-            ParamBase(names, replace), target_(target)
+    using ParamBase::file_values;
+    using ParamBase::encoding;
+    using ParamBase::help;
+
+    Param(T &target, StrVec names, bool replace):
+            ParamBase(std::move(names), replace), target_(target), scratch_()
     {}
-    virtual int parse(char **start, char **end);
+    virtual bool flag() const
+    {
+        return std::is_same<T, bool>::value;
+    }
+    virtual TypeInfo type() const
+    {
+        return type_info(static_cast<const T *>(nullptr));
+    }
+    virtual Str str() const
+    {
+        return format(target_, encoding_);
+    }
+    /**
+     * Keep values with ${name} references (parameter names with or without
+     * leading --, or environment variables) as text and interpolate them in
+     * dependency order: external targets at the end of parsing, or on read
+     * by Params::get if set afterwards, targets held by Params only when read
+     * by Params::get or value. Use $$ for a literal $.
+     */
+    Param<T> &interpolate(bool enable = true)
+    {
+        interpolate_ = enable;
+        return *this;
+    }
+    /** Set description of the parameter. */
+    Param<T> &help(const Str &text)
+    {
+        help_ = text;
+        return *this;
+    }
+    virtual void parse(const StrRef &value)
+    {
+#ifdef PROGRAM_PARAMS_HISTOGRAMS
+        auto start = Latency::Clock::now();
+#endif
+        // Convert and check aside, so that rejected values leave the target.
+        T &x = scratch_;
+        convert(value, x, encoding_);
+#ifdef PROGRAM_PARAMS_HISTOGRAMS
+        if (latency_)
+        {
+            latency_->convert.record(Latency::since(start));
+            start = Latency::Clock::now();
+        }
+#endif
+        for (const auto &check: checks_)
+        {
+            if (!check.first(x))
+            {
+                throw Exception(check.second);
+            }
+        }
+#ifdef PROGRAM_PARAMS_HISTOGRAMS
+        if (latency_ && !checks_.empty())
+        {
+            latency_->validate.record(Latency::since(start));
+        }
+#endif
+        using std::swap;
+        swap(target_, x);
+        mark_found();
+    }
+    /** Allow reading the value from a file given as @path. */
+    Param<T> &file_values(bool enable = true)
+    {
+        file_values_ = enable;
+        return *this;
+    }
+    /** Set encoding of blob values, base64 by default. */
+    Param<T> &encoding(Encoding encoding)
+    {
+        encoding_ = encoding;
+        return *this;
+    }
+    /** Require min <= value <= max. */
+    Param<T> &range(const T &min, const T &max)
+    {
+        checks_.emplace_back([min, max](const T &x) { return !(x < min) && !(max < x); },
+                             "Value out of range.");
+        constraints_.push_back(Constraint{ConstraintKind::Range,
+                                          format(min, encoding_), format(max, encoding_)});
+        return *this;
+    }
+    /** Require value > 0. */
+    Param<T> &positive()
+    {
+        checks_.emplace_back([](const T &x) { return T() < x; },
+                             "Value must be positive.");
+        constraints_.push_back(Constraint{ConstraintKind::Positive, Str(), Str()});
+        return *this;
+    }
+    /** Require integer value to be a power of two. */
+    Param<T> &power_of_two()
+    {
+        checks_.emplace_back([](const T &x) { return T() < x && (x & (x - 1)) == T(); },
+                             "Value must be a power of two.");
+        constraints_.push_back(Constraint{ConstraintKind::PowerOfTwo, Str(), Str()});
+        return *this;
+    }
+    /** Require the whole string value to match the regular expression. */
+    Param<T> &match(const Str &pattern)
+    {
+        static_assert(std::is_same<T, Str>::value, "Pattern requires string parameter.");
+        auto re = std::make_shared<std::regex>(pattern, std::regex::optimize);
+        checks_.emplace_back([re](const T &x) { return std::regex_match(x, *re); },
+                             "Value does not match pattern.");
+        constraints_.push_back(Constraint{ConstraintKind::Pattern, pattern, Str()});
+        return *this;
+    }
+    /** Require string value to be valid UTF-8. */
+    Param<T> &utf8()
+    {
+        static_assert(std::is_same<T, Str>::value, "UTF-8 validation requires string parameter.");
+        checks_.emplace_back([](const T &x) { return is_utf8(x.data(), x.size()); },
+                             "Invalid UTF-8 value.");
+        constraints_.push_back(Constraint{ConstraintKind::Utf8, Str(), Str()});
+        return *this;
+    }
+    /** Require custom predicate to hold, failing with the message. */
+    Param<T> &check(std::function<bool(const T &)> pred, const char *message)
+    {
+        checks_.emplace_back(std::move(pred), message);
+        constraints_.push_back(Constraint{ConstraintKind::Custom, message, Str()});
+        return *this;
+    }
+    /** Value of the target, a read counted by access counters. */
+    const T &value() const
+    {
+        resolve_pending();
+#ifdef PROGRAM_PARAMS_COUNTERS
+        reads_.increment();
+#endif
+        return target_;
+    }
     T &target_;
+protected:
+    std::vector<std::pair<std::function<bool(const T &)>, const char *>> checks_;
+    /** Value converted before checks, swapped with the target if accepted. */
+    T scratch_;
 };
 
-template<>
-int Param<bool>::parse(char **start, char **end)
+class ValueBase
+{
+public:
+    typedef std::shared_ptr<ValueBase> Ptr;
+};
+
+template<typename T>
+class Value: public ValueBase
+{
+public:
+    T value_;
+};
+
+class DerivedBase
+{
+public:
+    typedef std::shared_ptr<DerivedBase> Ptr;
+};
+
+template<typename T>
+class Derived;
+
+/** Sequence of indices 0, ..., N - 1, for expanding inputs. */
+template<size_t... I>
+struct Indices
+{};
+
+template<size_t N, size_t... I>
+struct MakeIndices: MakeIndices<N - 1, N - 1, I...>
+{};
+
+template<size_t... I>
+struct MakeIndices<0, I...>
+{
+    typedef Indices<I...> type;
+};
+
+/** Kind of a command-line argument. */
+enum class TokenKind: uint8_t
+{
+    Positional,     // Non-option, including empty and "-".
+    Terminator,     // "--"
+    Short,          // -x, possibly more options or value follow.
+    Long            // --name, possibly with =value.
+};
+
+/** Argument classified by a pre-scan. */
+struct Token
+{
+    const char *data;
+    uint32_t size;
+    uint32_t eq;    // Offset of the first '=', size if none.
+    TokenKind kind;
+
+    StrRef ref() const
+    {
+        return StrRef(data, size);
+    }
+};
+
+/** Length of null-terminated string and offset of its first '='. */
+inline void scan_scalar(const char *s, size_t &size, size_t &eq)
 {
-    assert(start < end);
-    target_ = true;
-    found_ = true;
-    return 0;
+    size = std::strlen(s);
+    const void *e = std::memchr(s, '=', size);
+    eq = e ? size_t(static_cast<const char *>(e) - s) : size;
 }
 
-template<>
-int Param<std::string>::parse(char **start, char **end)
+// Aligned block reads of scan_simd are invisible to AddressSanitizer.
+#if defined(__SANITIZE_ADDRESS__)
+#define PROGRAM_PARAMS_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define PROGRAM_PARAMS_ASAN 1
+#endif
+#endif
+
+/**
+ * Length of null-terminated string and offset of its first '=' in a single
+ * pass over aligned 16-byte blocks, which never cross a page boundary.
+ * Reading before the string and past its terminator is deliberate: such
+ * reads stay within pages of the string, but AddressSanitizer reports them,
+ * so sanitized builds scan bytewise.
+ */
+inline void scan_simd(const char *s, size_t &size, size_t &eq)
 {
-    assert(start < end);
-    int inc = 0;
-    target_ = value(start, end, inc);
-    found_ = true;
-    return inc;
+#if defined(__SSE2__) && !defined(PROGRAM_PARAMS_ASAN)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i equals = _mm_set1_epi8('=');
+    const size_t offset = size_t(reinterpret_cast<uintptr_t>(s) & 15);
+    const char *block = s - offset;
+    __m128i v = _mm_load_si128(reinterpret_cast<const __m128i *>(block));
+    unsigned z = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero))) >> offset;
+    unsigned e = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(v, equals))) >> offset;
+    size_t base = 0;
+    eq = size_t(-1);
+    for (;;)
+    {
+        if (eq == size_t(-1) && e)
+        {
+            unsigned i = unsigned(__builtin_ctz(e));
+            if (!z || i < unsigned(__builtin_ctz(z)))
+            {
+                eq = base + i;
+            }
+        }
+        if (z)
+        {
+            size = base + unsigned(__builtin_ctz(z));
+            break;
+        }
+        base = size_t(block + 16 - s);
+        block += 16;
+        v = _mm_load_si128(reinterpret_cast<const __m128i *>(block));
+        z = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)));
+        e = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(v, equals)));
+    }
+    if (eq == size_t(-1))
+    {
+        eq = size;
+    }
+#else
+    scan_scalar(s, size, eq);
+#endif
 }
 
-template<>
-int Param<int>::parse(char **start, char **end)
+inline Token make_token(const char *data, size_t size, size_t eq)
+{
+    if (size > std::numeric_limits<uint32_t>::max())
+    {
+        throw Exception("Argument too long.");
+    }
+    Token t;
+    t.data = data;
+    t.size = uint32_t(size);
+    t.eq = uint32_t(eq);
+    if (size < 2 || data[0] != '-')
+    {
+        t.kind = TokenKind::Positional;
+    }
+    else if (data[1] != '-')
+    {
+        t.kind = TokenKind::Short;
+    }
+    else
+    {
+        t.kind = size == 2 ? TokenKind::Terminator : TokenKind::Long;
+    }
+    return t;
+}
+
+inline Token make_token(const char *arg)
+{
+    size_t size = 0;
+    size_t eq = 0;
+    scan_simd(arg, size, eq);
+    return make_token(arg, size, eq);
+}
+
+inline Token make_token(const StrRef &arg)
+{
+    const void *e = std::memchr(arg.data(), '=', arg.size());
+    return make_token(arg.data(), arg.size(),
+                      e ? size_t(static_cast<const char *>(e) - arg.data()) : arg.size());
+}
+
+inline Token make_token(const Str &arg)
 {
-    assert(start < end);
-    int inc = 0;
-    target_ = std::stoi(value(start, end, inc));
-    found_ = true;
-    return inc;
+    return make_token(StrRef(arg));
 }
 
-template<>
-int Param<unsigned int>::parse(char **start, char **end)
+#if __cplusplus >= 201703L
+inline Token make_token(std::string_view arg)
+{
+    return make_token(StrRef(arg.data(), arg.size()));
+}
+#endif
+
+/** Classify all arguments into tokens. */
+template<typename It>
+void scan(It begin, It end, std::vector<Token> &tokens)
+{
+    tokens.resize(size_t(std::distance(begin, end)));
+    Token *t = tokens.data();
+    for (It it = begin; it != end; ++it)
+    {
+        *t++ = make_token(*it);
+    }
+}
+
+/** Range of arguments, e.g., a segment of argv, usable with Params::parse. */
+template<typename It>
+class ArgRange
+{
+public:
+    ArgRange():
+            begin_(), end_()
+    {}
+    ArgRange(It begin, It end):
+            begin_(begin), end_(end)
+    {}
+    It begin() const
+    {
+        return begin_;
+    }
+    It end() const
+    {
+        return end_;
+    }
+    size_t size() const
+    {
+        return size_t(std::distance(begin_, end_));
+    }
+    bool empty() const
+    {
+        return begin_ == end_;
+    }
+private:
+    It begin_;
+    It end_;
+};
+
+/**
+ * Split arguments into segments at any of the separators, e.g., "--" and ";;"
+ * in "--opts -- cmd args ;; cmd args". Segments are views of the arguments,
+ * separators are not part of any segment.
+ */
+template<typename It>
+class Segments
 {
-    assert(start < end);
-    int inc = 0;
-    target_ = std::stoul(value(start, end, inc));
-    found_ = true;
-    return inc;
-}
+public:
+    Segments(It begin, It end, std::initializer_list<StrRef> separators):
+            pos_(begin), end_(end), separators_(separators), done_(false)
+    {}
 
-template<>
-int Param<long>::parse(char **start, char **end)
-{
-    assert(start < end);
-    int inc = 0;
-    target_ = std::stol(value(start, end, inc));
-    found_ = true;
-    return inc;
-}
+    /** Get the next segment, false if there are no more. */
+    bool next(ArgRange<It> &segment)
+    {
+        if (done_)
+        {
+            return false;
+        }
+        It it = pos_;
+        while (it != end_ && !separator(StrRef(*it)))
+        {
+            ++it;
+        }
+        segment = ArgRange<It>(pos_, it);
+        done_ = it == end_;
+        pos_ = done_ ? it : std::next(it);
+        return true;
+    }
+    /** Arguments not yet split, e.g., to split them by other separators. */
+    ArgRange<It> rest() const
+    {
+        return ArgRange<It>(pos_, end_);
+    }
+private:
+    bool separator(const StrRef &arg) const
+    {
+        for (const auto &s: separators_)
+        {
+            if (arg == s)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
 
-template<>
-int Param<unsigned long>::parse(char **start, char **end)
-{
-    assert(start < end);
-    int inc = 0;
-    target_ = std::stoul(value(start, end, inc));
-    found_ = true;
-    return inc;
-}
+    It pos_;
+    It end_;
+    std::vector<StrRef> separators_;
+    bool done_;
+};
 
-template<>
-int Param<float>::parse(char **start, char **end)
+template<typename It>
+Segments<It> segments(It begin, It end, std::initializer_list<StrRef> separators)
 {
-    assert(start < end);
-    int inc = 0;
-    target_ = std::stof(value(start, end, inc));
-    found_ = true;
-    return inc;
+    return Segments<It>(begin, end, separators);
 }
 
-template<>
-int Param<double>::parse(char **start, char **end)
+/**
+ * Terminate a segment of main's argv by a null pointer in place of the
+ * separator following it, so that it can be passed to execv directly.
+ * The last segment is already terminated by argv[argc].
+ */
+inline char **terminate(const ArgRange<char **> &segment)
 {
-    assert(start < end);
-    int inc = 0;
-    target_ = std::stod(value(start, end, inc));
-    found_ = true;
-    return inc;
+    *segment.end() = nullptr;
+    return segment.begin();
 }
 
-class ValueBase
-{
-public:
-    typedef std::shared_ptr<ValueBase> Ptr;
-};
-
-template<typename T>
-class Value: public ValueBase
+/** How options and positional arguments may be mixed. */
+enum class ParseMode: uint8_t
 {
-public:
-    T value_;
+    Interleave,     // Options and positionals in any order (default).
+    Permute,        // As GNU getopt, extra positionals are kept as operands.
+    Stop            // As POSIX, options end at the first positional or "--".
 };
 
 class Params
@@ -215,15 +2449,29 @@ public:
     typedef std::vector<ParamBase::Ptr> Vec;
 
     Params(bool strict = true):
-            strict_(strict)
+            strict_(strict), mode_(ParseMode::Interleave), frozen_(false), unmapped_(false)
+#ifdef PROGRAM_PARAMS_HISTOGRAMS
+            , latency_(new Latency())
+#endif
     {}
 
     template<typename T>
-    void add(T &target, StrVec names, bool required = false)
+    Param<T> &add(T &target, StrVec names, bool required = false)
+    {
+        auto ptr = std::make_shared<Param<T>>(target, std::move(names), required);
+        add(ptr);
+        return *ptr;
+    }
+    /** Add parameter created elsewhere, e.g., in bulk storage. */
+    void add(const ParamBase::Ptr &ptr)
     {
-        auto ptr = std::make_shared<Param<T>>(target, names, required);
+#ifdef PROGRAM_PARAMS_HISTOGRAMS
+        ptr->latency_ = latency_.get();
+#endif
+        map_options();
+        frozen_ = false;
         bool option = false;
-        for (auto name: names)
+        for (const auto &name: ptr->names())
         {
             map_[name] = ptr;
             if (is_option(name))
@@ -239,63 +2487,356 @@ public:
         {
             positional_.push_back(ptr);
         }
+        params_.push_back(ptr);
+    }
+    /**
+     * Add parameters created elsewhere to no parameters added before, and
+     * freeze with a perfect hash of their option names built in advance,
+     * name i naming params[indexed[i]], e.g., by a Schema. Option names are
+     * mapped only if parameters are added later.
+     */
+    void add_frozen(Vec params, const PerfectHash &index, const std::vector<int32_t> &indexed)
+    {
+        if (!params_.empty())
+        {
+            for (const auto &ptr: params)
+            {
+                add(ptr);
+            }
+            freeze();
+            return;
+        }
+        params_ = std::move(params);
+        for (const auto &ptr: params_)
+        {
+#ifdef PROGRAM_PARAMS_HISTOGRAMS
+            ptr->latency_ = latency_.get();
+#endif
+            if (!ptr->option())
+            {
+                for (const auto &name: ptr->names())
+                {
+                    map_[name] = ptr;
+                }
+                positional_.push_back(ptr);
+            }
+        }
+        index_ = index;
+        indexed_.resize(indexed.size());
+        for (size_t i = 0; i < indexed.size(); ++i)
+        {
+            indexed_[i] = params_[size_t(indexed[i])].get();
+        }
+        frozen_ = true;
+        unmapped_ = true;
+    }
+    /** Reserve space for n parameters in total. */
+    void reserve(size_t n)
+    {
+        params_.reserve(n);
+        map_.reserve(n);
     }
     template<typename T>
-    void add(T &target, StrInit names, bool required = false)
+    Param<T> &add(T &target, StrInit names, bool required = false)
     {
-        add(target, StrVec(names), required);
+        return add(target, StrVec(names), required);
     }
+    /**
+     * Add parameter with target held by Params, read by get or value.
+     * Params must stay in place while interpolated values are read.
+     */
     template<typename T>
-    void add(StrVec names, bool required = false)
+    Param<T> &add(StrVec names, bool required = false)
     {
         auto ptr = std::make_shared<Value<T>>();
         values_.push_back(ptr);
-        add(ptr->value_, StrVec(names), required);
+        Param<T> &param = add(ptr->value_, StrVec(names), required);
+        static_cast<ParamBase &>(param).owner_ = this;
+        return param;
     }
     template<typename T>
-    void add(StrInit names, bool required = false)
+    Param<T> &add(StrInit names, bool required = false)
+    {
+        return add<T>(StrVec(names), required);
+    }
+    /**
+     * Add value computed by func from parameters named by inputs, of types
+     * Args, when read after any of them is parsed or set, e.g.,
+     *
+     *     auto &bytes = params.derive<size_t, int, size_t>({"--count", "--record-size"},
+     *             [](const int &count, const size_t &size) { return count * size; });
+     *     bytes.get();
+     *
+     * Parameters must be added before, func must depend on inputs only, and
+     * Params must stay in place while derived values are read.
+     */
+    template<typename T, typename... Args, typename F>
+    Derived<T> &derive(StrInit inputs, F func)
     {
-        add<T>(StrVec(names), required);
+        if (inputs.size() != sizeof...(Args))
+        {
+            throw Exception("Wrong number of derived inputs.");
+        }
+        std::vector<ParamBase *> params;
+        for (const auto &name: inputs)
+        {
+            params.push_back(find(StrRef(name)));
+            if (!params.back())
+            {
+                throw Exception("Parameter not found.");
+            }
+        }
+        auto ptr = std::make_shared<Derived<T>>(
+                *this, params, bind<T, Args...>(params, func, typename MakeIndices<sizeof...(Args)>::type()));
+        derived_.push_back(ptr);
+        return *ptr;
     }
     template<typename T>
     T & get(const Str &name)
     {
-        auto it = map_.find(name);
-        if (it == map_.end())
+        ParamBase *found = find(StrRef(name));
+        if (!found)
         {
             throw Exception("Parameter not found.");
         }
-        Param<T> *param = dynamic_cast<Param<T> *>(it->second.get());
+        Param<T> *param = dynamic_cast<Param<T> *>(found);
         if (!param)
         {
             throw Exception("Conversion not supported.");
         }
+        resolve(*param);
+#ifdef PROGRAM_PARAMS_COUNTERS
+        param->count_read();
+#endif
         return param->target_;
     }
-    void parse(int argc, char **argv)
+    /**
+     * Set parameter by name, e.g., from a config file, as if given on the
+     * command line. Unknown names are ignored unless strict.
+     */
+    void set(const StrRef &name, const StrRef &value)
+    {
+        ParamBase *param = find(name);
+        if (!param)
+        {
+            if (strict_)
+            {
+                throw Exception("Unknown option.");
+            }
+            return;
+        }
+        param->set(value);
+    }
+#ifdef PROGRAM_PARAMS_COUNTERS
+    /**
+     * Report parameters never set ("never set: --name") or set but never
+     * read ("never read: --name"), one per line. Only reads by get and by
+     * Param::value are seen, not reads of external targets directly.
+     */
+    Str unused_report() const
+    {
+        Str report;
+        for (const auto &p: params_)
+        {
+            if (p->sets() == 0)
+            {
+                report += "never set: " + p->name() + "\n";
+            }
+            else if (p->reads() == 0)
+            {
+                report += "never read: " + p->name() + "\n";
+            }
+        }
+        return report;
+    }
+#endif
+#ifdef PROGRAM_PARAMS_HISTOGRAMS
+    /** Latency histograms of parse calls and of conversion and checks of values. */
+    const Latency &latency() const
+    {
+        return *latency_;
+    }
+#endif
+    /** All parameters in order of declaration. */
+    const Vec &params() const
+    {
+        return params_;
+    }
+    bool strict() const
+    {
+        return strict_;
+    }
+    /**
+     * Build a perfect hash of option names, so that parsing looks names up
+     * without allocation. Adding parameters drops the index.
+     */
+    void freeze()
+    {
+        map_options();
+        std::vector<StrRef> keys;
+        keys.reserve(map_.size());
+        indexed_.clear();
+        indexed_.reserve(map_.size());
+        for (const auto &p: map_)
+        {
+            keys.push_back(StrRef(p.first));
+            indexed_.push_back(p.second.get());
+        }
+        index_.build(keys);
+        frozen_ = true;
+    }
+    /** Forget parameters found by previous parsing. */
+    void reset()
+    {
+        for (const auto &p: params_)
+        {
+            p->reset();
+        }
+    }
+    ParseMode mode() const
+    {
+        return mode_;
+    }
+    void mode(ParseMode mode)
+    {
+        mode_ = mode;
+    }
+    /** Positional arguments beyond declared parameters, in Permute mode. */
+    const std::vector<StrRef> &operands() const
+    {
+        return operands_;
+    }
+    /**
+     * Parse arguments, returning the index of the first argument not parsed:
+     * in Stop mode, the first positional argument or the one after "--",
+     * which are not even read, the number of arguments otherwise.
+     */
+    size_t parse(int argc, char **argv)
+    {
+        return parse_args(argv, argv + argc);
+    }
+    /**
+     * Parse arguments from iterators over const char *, std::string,
+     * std::string_view (C++17) or StrRef, e.g., parts of a command line.
+     * Arguments are used in place, they must outlive the parse.
+     */
+    template<typename It>
+    size_t parse(It begin, It end)
+    {
+        return parse_args(begin, end);
+    }
+    /** Parse arguments from a container, e.g., std::vector<std::string>. */
+    template<typename Range>
+    size_t parse(const Range &args)
+    {
+        return parse_args(std::begin(args), std::end(args));
+    }
+    size_t parse(std::initializer_list<const char *> args)
+    {
+        return parse_args(args.begin(), args.end());
+    }
+protected:
+    template<typename It>
+    size_t parse_args(It argv, It argv_end)
+    {
+#ifdef PROGRAM_PARAMS_HISTOGRAMS
+        struct Timer
+        {
+            Histogram &histogram;
+            Latency::Clock::time_point start;
+            ~Timer()
+            {
+                histogram.record(Latency::since(start));
+            }
+        } timer{latency_->parse, Latency::Clock::now()};
+#endif
+        operands_.clear();
+        size_t stop;
+        if (mode_ == ParseMode::Stop)
+        {
+            stop = parse_prefix(argv, argv_end);
+        }
+        else
+        {
+            scan(argv, argv_end, tokens_);
+            const Token *begin = tokens_.data();
+            stop = parse_tokens(begin, begin, begin + tokens_.size());
+        }
+        // Interpolate values of external targets, others are left to reads.
+        for (const auto &p: params_)
+        {
+            if (!p->owner_)
+            {
+                resolve(*p);
+            }
+            p->check();
+        }
+        return stop;
+    }
+    /**
+     * Scan and parse arguments up to the first positional argument which is
+     * not an option value, leaving the rest unread.
+     */
+    template<typename It>
+    size_t parse_prefix(It it, It end)
+    {
+        tokens_.clear();
+        size_t done = 0;
+        while (it != end)
+        {
+            do
+            {
+                tokens_.push_back(make_token(*it));
+                ++it;
+            }
+            while (it != end && tokens_.back().kind != TokenKind::Positional
+                   && tokens_.back().kind != TokenKind::Terminator);
+            const Token *argv = tokens_.data();
+            size_t stop = parse_tokens(argv, argv + done, argv + tokens_.size());
+            if (stop < tokens_.size())
+            {
+                // Skip the "--" terminating options.
+                return tokens_[stop].kind == TokenKind::Terminator ? stop + 1 : stop;
+            }
+            done = tokens_.size();
+        }
+        return tokens_.size();
+    }
+    /**
+     * Parse tokens from begin on, argv is the first argument for indices.
+     * Returns the index of the token stopping a Stop mode parse, or end.
+     */
+    size_t parse_tokens(const Token *argv, const Token *begin, const Token *end)
     {
         auto next = positional_.begin();
         bool positional_onward = false;
-        for (char **start = argv, **end = argv + argc; start < end;)
+        for (const Token *start = begin; start < end;)
         {
-            const std::string arg(start[0]);
-            if (positional_onward
-                    || arg.empty()
-                    || arg == "-"
-                    || arg[0] != '-')
+            const StrRef arg = start->ref();
+            if (mode_ == ParseMode::Stop && (start->kind == TokenKind::Positional
+                                             || start->kind == TokenKind::Terminator))
+            {
+                return size_t(start - argv);
+            }
+            if (positional_onward || start->kind == TokenKind::Positional)
             {
                 if (next < positional_.end())
                 {
-                    start += (*next)->parse(start, end);
+                    set(**next, arg, start - argv);
                     ++next;
                 }
+                else if (mode_ == ParseMode::Permute)
+                {
+                    operands_.push_back(arg);
+                }
                 else if (strict_)
                 {
                     throw Exception("Unknown positional parameter.");
                 }
+                ++start;
                 continue;
             }
-            if (arg == "--")
+            if (start->kind == TokenKind::Terminator)
             {
                 // The argument ‘--’ terminates all options; any following
                 // arguments are treated as non-option arguments, even if they
@@ -304,69 +2845,362 @@ public:
                 ++start;
                 continue;
             }
-            if (arg[1] != '-')
+            if (start->kind == TokenKind::Short)
             {
                 // Short option(s).
                 // Combined options in POSIX must not take arguments.
-                int inc;
+                int inc = 1;
                 for (size_t i = 1; i < arg.size(); ++i)
                 {
-                    std::string opt = "-" + arg.substr(i, 1);
-                    auto it = map_.find(opt);
-                    if (it != map_.end())
+                    const char opt[] = {'-', arg[i]};
+                    ParamBase *found = find(StrRef(opt, 2));
+                    if (found)
                     {
-                        if (i > 1)
+                        ParamBase &param = *found;
+                        if (param.flag())
+                        {
+                            param.parse(StrRef());
+                            continue;
+                        }
+                        // Value is either the rest of the option token
+                        // or a separate token.
+                        StrRef rest = arg.substr(i + 1);
+                        if (!rest.empty())
                         {
-                            // TODO: Check option has no arguments.
+                            set(param, rest[0] == '=' ? rest.substr(1) : rest,
+                                start - argv);
                         }
-                        inc = it->second->parse(start, end);
-                        if (inc > 0)
+                        else
                         {
-                            // Value parsed, either as a part of option token
-                            // or a separate token(s).
-                            break;
+                            set(param, option_value(start, end), start + 1 - argv);
+                            inc = 2;
                         }
+                        break;
                     }
                     else if (strict_)
                     {
                         throw Exception("Unknown short option.");
                     }
                 }
-                // Increment from parsing, or 1 if no value was encountered.
-                start += inc > 0 ? inc : 1;
+                start += inc;
             }
             else
             {
                 // Long option.
-                auto i = arg.find('=');
-                auto opt = arg.substr(0, i);
-                auto it = map_.find(opt);
-                if (it != map_.end())
+                const size_t i = start->eq;
+                ParamBase *found = find(arg.substr(0, i));
+                if (found)
                 {
-                    start += it->second->parse(start, end);
+                    ParamBase &param = *found;
+                    if (i < arg.size())
+                    {
+                        // Long option with equals delimiter.
+                        set(param, arg.substr(i + 1), start - argv);
+                        start += 1;
+                    }
+                    else if (param.flag())
+                    {
+                        param.parse(StrRef());
+                        start += 1;
+                    }
+                    else
+                    {
+                        set(param, option_value(start, end), start + 1 - argv);
+                        start += 2;
+                    }
                 }
                 else if (strict_)
                 {
                     throw Exception("Unknown long option.");
                 }
+                else
+                {
+                    // Skip unknown option, its value (if any) is unknown.
+                    start += 1;
+                }
             }
         }
-        for (const auto &p: map_)
+        return size_t(end - argv);
+    }
+    /** Map option names of parameters added frozen, e.g., before adding more. */
+    void map_options()
+    {
+        if (!unmapped_)
         {
-            p.second->check();
+            return;
         }
-        for (const auto &p: positional_)
+        for (const auto &p: params_)
         {
-            p->check();
+            if (p->option())
+            {
+                for (const auto &name: p->names())
+                {
+                    map_[name] = p;
+                }
+            }
         }
+        unmapped_ = false;
     }
-protected:
+    ParamBase *find(const StrRef &name) const
+    {
+        if (frozen_)
+        {
+            int32_t i = index_.find(name);
+            if (i >= 0 || !unmapped_ || (name.size() > 0 && name[0] == '-'))
+            {
+                return i >= 0 ? indexed_[i] : nullptr;
+            }
+            // Positional names of parameters added frozen are only mapped.
+        }
+        auto it = map_.find(name.str());
+        return it != map_.end() ? it->second.get() : nullptr;
+    }
+
+    /** Parameter referenced by ${name}, by its name or its name with leading --. */
+    ParamBase *find_reference(const StrRef &name) const
+    {
+        ParamBase *param = find(name);
+        if (!param && (name.empty() || name[0] != '-'))
+        {
+            Str option("--");
+            option.append(name.data(), name.size());
+            param = find(StrRef(option));
+        }
+        return param;
+    }
+
+    /**
+     * Interpolate a value kept as text, resolving referenced parameters
+     * first. The result is written into the text buffer sized in advance.
+     */
+    void resolve(ParamBase &param) const
+    {
+        typedef ParamBase::Pending Pending;
+        if (param.pending_ == Pending::None)
+        {
+            return;
+        }
+        if (param.pending_ == Pending::Resolving)
+        {
+            throw Exception(param.name() + ": Interpolation cycle.");
+        }
+        param.pending_ = Pending::Resolving;
+        Str result;
+        try
+        {
+            result = interpolated(param);
+        }
+        catch (...)
+        {
+            // Keep the text, so that later reads report the error again.
+            param.pending_ = Pending::Text;
+            throw;
+        }
+        param.text_.swap(result);
+        param.pending_ = Pending::None;
+        try
+        {
+            param.parse(StrRef(param.text_));
+        }
+        catch (const Exception &ex)
+        {
+            throw Exception(param.name() + ": " + ex.what());
+        }
+    }
+    /** Text of param with references replaced by values, resolving them first. */
+    Str interpolated(const ParamBase &param) const
+    {
+        // First pass: find references and their values, and the result size.
+        const Str &text = param.text_;
+        std::vector<StrRef> values;
+        std::vector<Str> formatted;
+        formatted.reserve(std::count(text.begin(), text.end(), '$'));
+        size_t size = 0;
+        for (size_t i = 0; i < text.size();)
+        {
+            size_t dollar = text.find('$', i);
+            if (dollar == Str::npos)
+            {
+                dollar = text.size();
+            }
+            values.push_back(StrRef(text.data() + i, dollar - i));
+            i = dollar;
+            if (i == text.size())
+            {
+                break;
+            }
+            if (i + 1 < text.size() && text[i + 1] == '$')
+            {
+                values.push_back(StrRef("$"));
+                i += 2;
+                continue;
+            }
+            if (i + 1 == text.size() || text[i + 1] != '{')
+            {
+                values.push_back(StrRef("$"));
+                ++i;
+                continue;
+            }
+            size_t close = text.find('}', i + 2);
+            if (close == Str::npos)
+            {
+                throw Exception(param.name() + ": Unterminated interpolation.");
+            }
+            StrRef name(text.data() + i + 2, close - i - 2);
+            i = close + 1;
+            ParamBase *ref = find_reference(name);
+            if (ref)
+            {
+                resolve(*ref);
+                formatted.push_back(ref->str());
+                values.push_back(StrRef(formatted.back()));
+                continue;
+            }
+            const char *env = std::getenv(name.str().c_str());
+            if (!env)
+            {
+                throw Exception(param.name() + ": Undefined reference " + name.str() + ".");
+            }
+            values.push_back(StrRef(env));
+        }
+        for (const auto &v: values)
+        {
+            size += v.size();
+        }
+        // Second pass: write into a buffer of final size.
+        Str result(size, '\0');
+        char *out = &result[0];
+        for (const auto &v: values)
+        {
+            std::memcpy(out, v.data(), v.size());
+            out += v.size();
+        }
+        return result;
+    }
+
+    /** Function of typed targets of params. */
+    template<typename T, typename... Args, typename F, size_t... I>
+    static std::function<T()> bind(const std::vector<ParamBase *> &params, F func, Indices<I...>)
+    {
+        std::tuple<Param<Args> *...> typed(dynamic_cast<Param<Args> *>(params[I])...);
+        const bool valid[] = {true, std::get<I>(typed) != nullptr...};
+        for (bool v: valid)
+        {
+            if (!v)
+            {
+                throw Exception("Conversion not supported.");
+            }
+        }
+        return [func, typed]()
+        {
+            return T(func(std::get<I>(typed)->target_...));
+        };
+    }
+
+    /** Set the parameter, reporting failures with name and argument index. */
+    static void set(ParamBase &param, const StrRef &value, long index)
+    {
+        try
+        {
+            param.set(value);
+        }
+        catch (const Exception &ex)
+        {
+            throw ValueException(param.name(), int(index), ex.what());
+        }
+    }
+
+    static StrRef option_value(const Token *start, const Token *end)
+    {
+        if (start + 1 >= end)
+        {
+            throw Exception("Missing parameter value.");
+        }
+        return start[1].ref();
+    }
+
     bool strict_;
+    ParseMode mode_;
+    Vec params_;
     Map map_;
     Vec positional_;
     std::vector<ValueBase::Ptr> values_;
+    bool frozen_;
+    /** Option names of parameters added frozen are not in map_ yet. */
+    bool unmapped_;
+    PerfectHash index_;
+    std::vector<ParamBase *> indexed_;
+    /** Arguments classified by pre-scan, reused between parses. */
+    std::vector<Token> tokens_;
+    std::vector<StrRef> operands_;
+    std::vector<DerivedBase::Ptr> derived_;
+#ifdef PROGRAM_PARAMS_HISTOGRAMS
+    /** Shared by copies, as are the parameters recording into it. */
+    std::shared_ptr<Latency> latency_;
+#endif
+
+    friend class ParamBase;
+    template<typename T>
+    friend class Derived;
+};
+
+/**
+ * Value computed from parameters, memoized until any of them changes. Reading
+ * resolves deferred interpolation of inputs and compares their versions with
+ * those seen by the last evaluation.
+ */
+template<typename T>
+class Derived: public DerivedBase
+{
+public:
+    Derived(const Params &params, std::vector<ParamBase *> inputs, std::function<T()> func):
+            params_(params), inputs_(std::move(inputs)), versions_(inputs_.size()),
+            func_(std::move(func)), value_(), valid_(false), evaluations_(0)
+    {}
+
+    const T &get() const
+    {
+        bool valid = valid_;
+        for (size_t i = 0; i < inputs_.size(); ++i)
+        {
+            params_.resolve(*inputs_[i]);
+            valid = valid && inputs_[i]->version() == versions_[i];
+        }
+        if (!valid)
+        {
+            value_ = func_();
+            for (size_t i = 0; i < inputs_.size(); ++i)
+            {
+                versions_[i] = inputs_[i]->version();
+            }
+            valid_ = true;
+            ++evaluations_;
+        }
+        return value_;
+    }
+    /** Number of evaluations so far. */
+    uint64_t evaluations() const
+    {
+        return evaluations_;
+    }
+private:
+    const Params &params_;
+    std::vector<ParamBase *> inputs_;
+    mutable std::vector<uint64_t> versions_;
+    std::function<T()> func_;
+    mutable T value_;
+    mutable bool valid_;
+    mutable uint64_t evaluations_;
 };
 
+inline void ParamBase::resolve_pending() const
+{
+    if (owner_ && pending_ != Pending::None)
+    {
+        owner_->resolve(const_cast<ParamBase &>(*this));
+    }
+}
+
 }
 
 #endif //PROGRAM_PARAMS_PROGRAM_PARAMS_H
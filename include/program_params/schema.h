@@ -0,0 +1,881 @@
+/*
+Parameter schema in a compact, versioned binary format, so that external
+tools (completion scripts, documentation generators, config validators) can
+read names, types, defaults, constraints and help without running the
+program:
+
+    std::ofstream("app.schema", std::ios::binary) << save_schema(params);
+
+    MappedFile file("app.schema");
+    Schema schema(file.ref());
+    schema.validate("--count", "5");
+
+All fields are little endian:
+
+    header      magic "PPSC", version, flags, counts of params, names and
+                constraints, size of string pool (8 x u32)
+    params      type, signed, rounding, flags (4 x u8), bits, extra,
+                first name, name count, first constraint, constraint count,
+                default, help (string = offset, size into pool)
+    names       string
+    constraints kind (u32), first, second (strings)
+    pool        bytes of all strings
+
+Custom checks are exported with their message only, they are not evaluated
+by the loader.
+
+A schema may also declare parameters at runtime, e.g., for plugins which
+describe their parameters in data; load_schema() adds all of them with
+targets in the library's storage in one bulk build:
+
+    load_schema(params, schema);
+    params.parse(argc, argv);
+    auto count = params.get<int32_t>("--count");
+*/
+
+#ifndef PROGRAM_PARAMS_SCHEMA_H
+#define PROGRAM_PARAMS_SCHEMA_H
+
+#include <program_params/program_params.h>
+
+namespace program_params
+{
+
+namespace schema_format
+{
+
+const char magic[4] = {'P', 'P', 'S', 'C'};
+/** Version 2 adds UTF-8 constraints, version 1 schemas are still read. */
+const uint32_t version = 2;
+const uint32_t min_version = 1;
+const size_t header_size = 32;
+const size_t param_size = 44;
+const size_t name_size = 8;
+const size_t constraint_size = 20;
+
+enum Flags: uint8_t
+{
+    Strict = 1,
+    Option = 1,
+    Required = 2,
+    FileValues = 4,
+    Hex = 8
+};
+
+inline void put_u32(Str &out, uint32_t x)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        out += char(uint8_t(x >> (8 * i)));
+    }
+}
+
+inline uint32_t get_u32(const char *p)
+{
+    const uint8_t *u = reinterpret_cast<const uint8_t *>(p);
+    return uint32_t(u[0]) | uint32_t(u[1]) << 8 | uint32_t(u[2]) << 16 | uint32_t(u[3]) << 24;
+}
+
+/** String pool with (offset, size) references. */
+class Pool
+{
+public:
+    void put(Str &out, const Str &s)
+    {
+        put_u32(out, uint32_t(data_.size()));
+        put_u32(out, uint32_t(s.size()));
+        data_ += s;
+    }
+    const Str &data() const
+    {
+        return data_;
+    }
+private:
+    Str data_;
+};
+
+}
+
+/** Serialize names, types, defaults, constraints and help of all parameters. */
+inline Str save_schema(const Params &params)
+{
+    using namespace schema_format;
+    Str records, names, constraints;
+    Pool pool;
+    uint32_t name_count = 0, constraint_count = 0;
+    for (const auto &p: params.params())
+    {
+        TypeInfo type = p->type();
+        records += char(type.type);
+        records += char(type.is_signed);
+        records += char(type.rounding);
+        records += char((p->option() ? Option : 0) | (p->required() ? Required : 0)
+                        | (p->file_values() ? FileValues : 0)
+                        | (p->encoding() == Encoding::Hex ? Hex : 0));
+        put_u32(records, type.bits);
+        put_u32(records, type.extra);
+        put_u32(records, name_count);
+        put_u32(records, uint32_t(p->names().size()));
+        put_u32(records, constraint_count);
+        put_u32(records, uint32_t(p->constraints().size()));
+        pool.put(records, p->str());
+        pool.put(records, p->help());
+        for (const auto &name: p->names())
+        {
+            pool.put(names, name);
+            ++name_count;
+        }
+        for (const auto &c: p->constraints())
+        {
+            put_u32(constraints, uint32_t(c.kind));
+            pool.put(constraints, c.first);
+            pool.put(constraints, c.second);
+            ++constraint_count;
+        }
+    }
+    Str out(magic, sizeof(magic));
+    put_u32(out, version);
+    put_u32(out, params.strict() ? Strict : 0);
+    put_u32(out, uint32_t(params.params().size()));
+    put_u32(out, name_count);
+    put_u32(out, constraint_count);
+    put_u32(out, uint32_t(pool.data().size()));
+    put_u32(out, 0);
+    out += records;
+    out += names;
+    out += constraints;
+    out += pool.data();
+    return out;
+}
+
+/** Parameter of a loaded schema, strings refer to the schema data. */
+struct SchemaParam
+{
+    TypeInfo type;
+    bool option;
+    bool required;
+    bool file_values;
+    Encoding encoding;
+    /** Names are names[first_name, first_name + name_count) of the schema. */
+    uint32_t first_name;
+    uint32_t name_count;
+    uint32_t first_constraint;
+    uint32_t constraint_count;
+    StrRef default_value;
+    StrRef help;
+};
+
+struct SchemaConstraint
+{
+    ConstraintKind kind;
+    StrRef first;
+    StrRef second;
+};
+
+/**
+ * Schema loaded from serialized data (e.g., a MappedFile), which must
+ * outlive it. Options are looked up by a perfect hash of their names.
+ */
+class Schema
+{
+public:
+    explicit Schema(const StrRef &data)
+    {
+        using namespace schema_format;
+        if (data.size() < header_size || std::memcmp(data.data(), magic, sizeof(magic)) != 0)
+        {
+            throw Exception("Invalid schema.");
+        }
+        const char *p = data.data();
+        if (get_u32(p + 4) < min_version || get_u32(p + 4) > version)
+        {
+            throw Exception("Unsupported schema version.");
+        }
+        strict_ = (get_u32(p + 8) & Strict) != 0;
+        uint64_t param_count = get_u32(p + 12);
+        uint64_t name_count = get_u32(p + 16);
+        uint64_t constraint_count = get_u32(p + 20);
+        uint64_t pool_size = get_u32(p + 24);
+        if (data.size() != header_size + param_count * param_size + name_count * name_size
+                           + constraint_count * constraint_size + pool_size)
+        {
+            throw Exception("Invalid schema size.");
+        }
+        const char *q = p + header_size;
+        const char *pool = data.data() + data.size() - pool_size;
+        auto str = [pool, pool_size](const char *r)
+        {
+            uint64_t offset = get_u32(r), size = get_u32(r + 4);
+            if (offset + size > pool_size)
+            {
+                throw Exception("Invalid schema string.");
+            }
+            return StrRef(pool + offset, size_t(size));
+        };
+
+        params_.resize(size_t(param_count));
+        for (auto &param: params_)
+        {
+            uint8_t type = uint8_t(q[0]), rounding = uint8_t(q[2]), flags = uint8_t(q[3]);
+            if (type > uint8_t(ValueType::Decimal) || rounding > uint8_t(Rounding::HalfEven))
+            {
+                throw Exception("Invalid schema type.");
+            }
+            param.type = TypeInfo{ValueType(type), q[1] != 0, get_u32(q + 4), get_u32(q + 8),
+                                  Rounding(rounding)};
+            if (param.type.type == ValueType::Decimal && param.type.extra > max_scale(param.type))
+            {
+                throw Exception("Invalid schema decimal scale.");
+            }
+            param.option = (flags & Option) != 0;
+            param.required = (flags & Required) != 0;
+            param.file_values = (flags & FileValues) != 0;
+            param.encoding = flags & Hex ? Encoding::Hex : Encoding::Base64;
+            param.first_name = get_u32(q + 12);
+            param.name_count = get_u32(q + 16);
+            param.first_constraint = get_u32(q + 20);
+            param.constraint_count = get_u32(q + 24);
+            param.default_value = str(q + 28);
+            param.help = str(q + 36);
+            if (uint64_t(param.first_name) + param.name_count > name_count
+                || uint64_t(param.first_constraint) + param.constraint_count > constraint_count)
+            {
+                throw Exception("Invalid schema parameter.");
+            }
+            q += param_size;
+        }
+
+        names_.resize(size_t(name_count));
+        for (auto &name: names_)
+        {
+            name = str(q);
+            q += name_size;
+        }
+
+        constraints_.resize(size_t(constraint_count));
+        for (auto &c: constraints_)
+        {
+            uint32_t kind = get_u32(q);
+            if (kind > uint32_t(ConstraintKind::Utf8))
+            {
+                throw Exception("Invalid schema constraint.");
+            }
+            c.kind = ConstraintKind(kind);
+            c.first = str(q + 4);
+            c.second = str(q + 12);
+            q += constraint_size;
+        }
+
+        std::vector<StrRef> keys;
+        for (size_t i = 0; i < params_.size(); ++i)
+        {
+            const SchemaParam &param = params_[i];
+            for (uint32_t j = 0; j < param.constraint_count; ++j)
+            {
+                const SchemaConstraint &c = constraints_[param.first_constraint + j];
+                if (c.kind == ConstraintKind::Pattern)
+                {
+                    patterns_[param.first_constraint + j] = std::make_shared<std::regex>(
+                            c.first.str(), std::regex::optimize);
+                }
+            }
+            if (!param.option)
+            {
+                continue;
+            }
+            for (uint32_t j = 0; j < param.name_count; ++j)
+            {
+                keys.push_back(names_[param.first_name + j]);
+                indexed_.push_back(int32_t(i));
+            }
+        }
+        check_distinct(keys);
+        index_.build(keys);
+    }
+
+    bool strict() const
+    {
+        return strict_;
+    }
+    size_t size() const
+    {
+        return params_.size();
+    }
+    const SchemaParam &operator[](size_t i) const
+    {
+        return params_[i];
+    }
+    const std::vector<StrRef> &names() const
+    {
+        return names_;
+    }
+    const std::vector<SchemaConstraint> &constraints() const
+    {
+        return constraints_;
+    }
+    /** Perfect hash of option names, name i naming the parameter indexed()[i]. */
+    const PerfectHash &index() const
+    {
+        return index_;
+    }
+    const std::vector<int32_t> &indexed() const
+    {
+        return indexed_;
+    }
+    /** Index of option with given name, -1 if not found. */
+    int32_t find(const StrRef &name) const
+    {
+        int32_t i = index_.find(name);
+        return i < 0 ? -1 : indexed_[size_t(i)];
+    }
+
+    /** Check that value would be accepted by given parameter, throw otherwise. */
+    void validate(const SchemaParam &param, const StrRef &value) const
+    {
+        if (param.file_values && value.size() > 1 && value[0] == '@')
+        {
+            if (value[1] == '@')
+            {
+                check(param, value.substr(1));
+                return;
+            }
+            MappedFile file(value.substr(1).str());
+            check(param, file.ref());
+            return;
+        }
+        check(param, value);
+    }
+    void validate(const StrRef &name, const StrRef &value) const
+    {
+        int32_t i = find(name);
+        if (i < 0)
+        {
+            throw Exception("Parameter not found.");
+        }
+        validate(params_[size_t(i)], value);
+    }
+private:
+    static void check_distinct(std::vector<StrRef> keys)
+    {
+        auto less = [](const StrRef &a, const StrRef &b)
+        {
+            int c = std::memcmp(a.data(), b.data(), std::min(a.size(), b.size()));
+            return c < 0 || (c == 0 && a.size() < b.size());
+        };
+        std::sort(keys.begin(), keys.end(), less);
+        if (std::adjacent_find(keys.begin(), keys.end()) != keys.end())
+        {
+            throw Exception("Duplicate option in schema.");
+        }
+    }
+
+    template<typename T>
+    static bool power_of_two(const T &x, std::true_type)
+    {
+        return T() < x && (x & (x - 1)) == T();
+    }
+    template<typename T>
+    static bool power_of_two(const T &, std::false_type)
+    {
+        return false;
+    }
+
+    /** Convert value and bounds as T and apply declared constraints. */
+    template<typename T, bool Integer = false>
+    void check_as(const SchemaParam &param, const StrRef &value) const
+    {
+        T x = T();
+        convert(value, x, param.encoding);
+        for (uint32_t j = 0; j < param.constraint_count; ++j)
+        {
+            size_t k = param.first_constraint + j;
+            const SchemaConstraint &c = constraints_[k];
+            switch (c.kind)
+            {
+            case ConstraintKind::Range:
+            {
+                T min = T(), max = T();
+                convert(c.first, min, param.encoding);
+                convert(c.second, max, param.encoding);
+                if (x < min || max < x)
+                {
+                    throw Exception("Value out of range.");
+                }
+                break;
+            }
+            case ConstraintKind::Positive:
+                if (!(T() < x))
+                {
+                    throw Exception("Value must be positive.");
+                }
+                break;
+            case ConstraintKind::PowerOfTwo:
+                if (!power_of_two(x, std::integral_constant<bool, Integer>()))
+                {
+                    throw Exception("Value must be a power of two.");
+                }
+                break;
+            case ConstraintKind::Pattern:
+                if (!std::regex_match(value.data(), value.data() + value.size(),
+                                      *patterns_.at(k)))
+                {
+                    throw Exception("Value does not match pattern.");
+                }
+                break;
+            case ConstraintKind::Utf8:
+                if (!is_utf8(value.data(), value.size()))
+                {
+                    throw Exception("Invalid UTF-8 value.");
+                }
+                break;
+            case ConstraintKind::Custom:
+                break;
+            }
+        }
+    }
+
+    template<typename T>
+    void check_decimal(const SchemaParam &param, const StrRef &value) const
+    {
+        const TypeInfo &t = param.type;
+        T x = parse_decimal<T>(value, t.extra, t.rounding);
+        for (uint32_t j = 0; j < param.constraint_count; ++j)
+        {
+            const SchemaConstraint &c = constraints_[param.first_constraint + j];
+            if (c.kind == ConstraintKind::Range
+                && (x < parse_decimal<T>(c.first, t.extra, Rounding::Exact)
+                    || parse_decimal<T>(c.second, t.extra, Rounding::Exact) < x))
+            {
+                throw Exception("Value out of range.");
+            }
+            if (c.kind == ConstraintKind::Positive && !(T() < x))
+            {
+                throw Exception("Value must be positive.");
+            }
+        }
+    }
+
+    void check(const SchemaParam &param, const StrRef &value) const
+    {
+        const TypeInfo &t = param.type;
+        switch (t.type)
+        {
+        case ValueType::Bool:
+            check_as<bool>(param, value);
+            break;
+        case ValueType::String:
+            check_as<Str>(param, value);
+            break;
+        case ValueType::Integer:
+            if (t.bits <= 32)
+            {
+                t.is_signed ? check_as<int32_t, true>(param, value)
+                            : check_as<uint32_t, true>(param, value);
+            }
+#ifdef __SIZEOF_INT128__
+            else if (t.bits > 64)
+            {
+                t.is_signed ? check_as<int128_t, true>(param, value)
+                            : check_as<uint128_t, true>(param, value);
+            }
+#endif
+            else
+            {
+                t.is_signed ? check_as<long long, true>(param, value)
+                            : check_as<unsigned long long, true>(param, value);
+            }
+            break;
+        case ValueType::Float:
+            t.bits <= 32 ? check_as<float>(param, value) : check_as<double>(param, value);
+            break;
+        case ValueType::Blob:
+        {
+            std::vector<uint8_t> x;
+            convert(value, x, param.encoding);
+            if (t.extra && x.size() != t.extra)
+            {
+                throw Exception("Invalid blob length.");
+            }
+            break;
+        }
+        case ValueType::Decimal:
+            if (t.bits <= 32)
+            {
+                t.is_signed ? check_decimal<int32_t>(param, value)
+                            : check_decimal<uint32_t>(param, value);
+            }
+#ifdef __SIZEOF_INT128__
+            else if (t.bits > 64)
+            {
+                t.is_signed ? check_decimal<int128_t>(param, value)
+                            : check_decimal<uint128_t>(param, value);
+            }
+#endif
+            else
+            {
+                t.is_signed ? check_decimal<long long>(param, value)
+                            : check_decimal<unsigned long long>(param, value);
+            }
+            break;
+        case ValueType::Other:
+            break;
+        }
+    }
+    /** Largest scale of decimals in the representation checked for t. */
+    static uint32_t max_scale(const TypeInfo &t)
+    {
+        int digits = t.is_signed ? IntegerTraits<long long>::digits10 + 0
+                                 : IntegerTraits<unsigned long long>::digits10 + 0;
+        if (t.bits <= 32)
+        {
+            digits = t.is_signed ? IntegerTraits<int32_t>::digits10 + 0
+                                 : IntegerTraits<uint32_t>::digits10 + 0;
+        }
+#ifdef __SIZEOF_INT128__
+        else if (t.bits > 64)
+        {
+            digits = IntegerTraits<int128_t>::digits10 + 0;
+        }
+#endif
+        return uint32_t(digits);
+    }
+
+    bool strict_;
+    std::vector<SchemaParam> params_;
+    std::vector<StrRef> names_;
+    std::vector<SchemaConstraint> constraints_;
+    std::unordered_map<size_t, std::shared_ptr<std::regex>> patterns_;
+    PerfectHash index_;
+    std::vector<int32_t> indexed_;
+};
+
+
+/**
+ * Parameters of one type with their targets, allocated at once for a bulk
+ * load and shared by the parameters through aliasing pointers.
+ */
+template<typename T>
+class ParamBlock
+{
+public:
+    explicit ParamBlock(size_t n):
+            values_(new T[n]())
+    {
+        params_.reserve(n);
+    }
+    std::unique_ptr<T[]> values_;
+    std::vector<Param<T>> params_;
+};
+
+namespace schema_format
+{
+
+/** Target type used for loaded parameters. */
+enum Slot
+{
+    SlotBool,
+    SlotString,
+    SlotInt32,
+    SlotUInt32,
+    SlotInt64,
+    SlotUInt64,
+    SlotInt128,
+    SlotUInt128,
+    SlotFloat,
+    SlotDouble,
+    SlotBlob,
+    SlotCount
+};
+
+inline Slot slot(const TypeInfo &t)
+{
+    switch (t.type)
+    {
+    case ValueType::Bool:
+        return SlotBool;
+    case ValueType::Integer:
+#ifdef __SIZEOF_INT128__
+        if (t.bits > 64)
+        {
+            return t.is_signed ? SlotInt128 : SlotUInt128;
+        }
+#endif
+        if (t.bits > 32)
+        {
+            return t.is_signed ? SlotInt64 : SlotUInt64;
+        }
+        return t.is_signed ? SlotInt32 : SlotUInt32;
+    case ValueType::Float:
+        return t.bits > 32 ? SlotDouble : SlotFloat;
+    case ValueType::Blob:
+        return SlotBlob;
+    default:
+        // Decimals with runtime scale are kept as checked strings.
+        return SlotString;
+    }
+}
+
+template<typename T>
+void add_power_of_two(Param<T> &param, std::true_type)
+{
+    param.power_of_two();
+}
+
+template<typename T>
+void add_power_of_two(Param<T> &, std::false_type)
+{}
+
+template<typename T>
+void add_pattern(Param<T> &, const Str &)
+{}
+
+inline void add_pattern(Param<Str> &param, const Str &pattern)
+{
+    param.match(pattern);
+}
+
+template<typename T>
+void add_utf8(Param<T> &)
+{}
+
+inline void add_utf8(Param<Str> &param)
+{
+    param.utf8();
+}
+
+template<typename T>
+void add_blob_size(Param<T> &, size_t)
+{}
+
+inline void add_blob_size(Param<std::vector<uint8_t>> &param, size_t n)
+{
+    param.check([n](const std::vector<uint8_t> &x) { return x.size() == n; },
+                "Invalid blob length.");
+}
+
+template<typename T>
+void add_decimal_check(Param<T> &, const TypeInfo &, const StrRef &, const StrRef &, bool)
+{}
+
+/** Checks of decimal value kept as text, in representation Rep. */
+template<typename Rep>
+void add_decimal_check_as(Param<Str> &param, const TypeInfo &t, const StrRef &min,
+                          const StrRef &max, bool positive)
+{
+    unsigned scale = t.extra;
+    Rounding rounding = t.rounding;
+    bool range = !min.empty() || !max.empty();
+    if (range)
+    {
+        Rep lo = parse_decimal<Rep>(min, scale, Rounding::Exact);
+        Rep hi = parse_decimal<Rep>(max, scale, Rounding::Exact);
+        param.check([scale, rounding, lo, hi](const Str &x)
+                    {
+                        Rep v = parse_decimal<Rep>(x, scale, rounding);
+                        return !(v < lo) && !(hi < v);
+                    },
+                    "Value out of range.");
+    }
+    if (positive)
+    {
+        param.check([scale, rounding](const Str &x)
+                    {
+                        return Rep() < parse_decimal<Rep>(x, scale, rounding);
+                    },
+                    "Value must be positive.");
+    }
+    if (!range && !positive)
+    {
+        // Still reject values the representation does not hold.
+        param.check([scale, rounding](const Str &x)
+                    {
+                        parse_decimal<Rep>(x, scale, rounding);
+                        return true;
+                    },
+                    "Value out of range.");
+    }
+}
+
+inline void add_decimal_check(Param<Str> &param, const TypeInfo &t, const StrRef &min,
+                              const StrRef &max, bool positive)
+{
+    if (t.bits <= 32)
+    {
+        t.is_signed ? add_decimal_check_as<int32_t>(param, t, min, max, positive)
+                    : add_decimal_check_as<uint32_t>(param, t, min, max, positive);
+    }
+#ifdef __SIZEOF_INT128__
+    else if (t.bits > 64)
+    {
+        t.is_signed ? add_decimal_check_as<int128_t>(param, t, min, max, positive)
+                    : add_decimal_check_as<uint128_t>(param, t, min, max, positive);
+    }
+#endif
+    else
+    {
+        t.is_signed ? add_decimal_check_as<long long>(param, t, min, max, positive)
+                    : add_decimal_check_as<unsigned long long>(param, t, min, max, positive);
+    }
+}
+
+template<typename T, bool Integer = false>
+void load_param(Params::Vec &params, const Schema &schema, const SchemaParam &p,
+                const std::shared_ptr<ParamBlock<T>> &block)
+{
+    StrVec names;
+    names.reserve(p.name_count);
+    for (uint32_t j = 0; j < p.name_count; ++j)
+    {
+        names.push_back(schema.names()[p.first_name + j].str());
+    }
+    T &target = block->values_[block->params_.size()];
+    block->params_.emplace_back(target, std::move(names), p.required);
+    Param<T> &param = block->params_.back();
+    param.file_values(p.file_values).encoding(p.encoding).help(p.help.str());
+    if (!p.default_value.empty())
+    {
+        convert(p.default_value, target, p.encoding);
+    }
+    if (p.type.type == ValueType::Blob && p.type.extra)
+    {
+        add_blob_size(param, p.type.extra);
+    }
+    StrRef decimal_min, decimal_max;
+    bool decimal_positive = false;
+    for (uint32_t j = 0; j < p.constraint_count; ++j)
+    {
+        const SchemaConstraint &c = schema.constraints()[p.first_constraint + j];
+        switch (c.kind)
+        {
+        case ConstraintKind::Range:
+            if (p.type.type == ValueType::Decimal)
+            {
+                decimal_min = c.first;
+                decimal_max = c.second;
+                break;
+            }
+            {
+                T min = T(), max = T();
+                convert(c.first, min, p.encoding);
+                convert(c.second, max, p.encoding);
+                param.range(min, max);
+            }
+            break;
+        case ConstraintKind::Positive:
+            if (p.type.type == ValueType::Decimal)
+            {
+                decimal_positive = true;
+                break;
+            }
+            param.positive();
+            break;
+        case ConstraintKind::PowerOfTwo:
+            add_power_of_two(param, std::integral_constant<bool, Integer>());
+            break;
+        case ConstraintKind::Pattern:
+            add_pattern(param, c.first.str());
+            break;
+        case ConstraintKind::Utf8:
+            add_utf8(param);
+            break;
+        case ConstraintKind::Custom:
+            break;
+        }
+    }
+    if (p.type.type == ValueType::Decimal)
+    {
+        add_decimal_check(param, p.type, decimal_min, decimal_max, decimal_positive);
+    }
+    params.push_back(ParamBase::Ptr(block, &param));
+}
+
+template<typename T>
+std::shared_ptr<ParamBlock<T>> make_block(size_t n)
+{
+    return n ? std::make_shared<ParamBlock<T>>(n) : std::shared_ptr<ParamBlock<T>>();
+}
+
+}
+
+/**
+ * Add parameters described by a schema, with targets in storage owned by
+ * params, and freeze with the index of the schema. Parameters and targets of
+ * each type are allocated as one block. Decimals are loaded as strings checked for scale and range,
+ * custom checks are not restored. Read values by get<T>(name) with bool,
+ * Str, int32_t, uint32_t, long long, unsigned long long, 128-bit integers,
+ * float, double or std::vector<uint8_t> by the declared type.
+ */
+inline void load_schema(Params &params, const Schema &schema)
+{
+    using namespace schema_format;
+    size_t counts[SlotCount] = {};
+    for (size_t i = 0; i < schema.size(); ++i)
+    {
+        ++counts[slot(schema[i].type)];
+    }
+    auto bools = make_block<bool>(counts[SlotBool]);
+    auto strings = make_block<Str>(counts[SlotString]);
+    auto int32s = make_block<int32_t>(counts[SlotInt32]);
+    auto uint32s = make_block<uint32_t>(counts[SlotUInt32]);
+    auto int64s = make_block<long long>(counts[SlotInt64]);
+    auto uint64s = make_block<unsigned long long>(counts[SlotUInt64]);
+#ifdef __SIZEOF_INT128__
+    auto int128s = make_block<int128_t>(counts[SlotInt128]);
+    auto uint128s = make_block<uint128_t>(counts[SlotUInt128]);
+#endif
+    auto floats = make_block<float>(counts[SlotFloat]);
+    auto doubles = make_block<double>(counts[SlotDouble]);
+    auto blobs = make_block<std::vector<uint8_t>>(counts[SlotBlob]);
+
+    Params::Vec loaded;
+    loaded.reserve(schema.size());
+    for (size_t i = 0; i < schema.size(); ++i)
+    {
+        const SchemaParam &p = schema[i];
+        switch (slot(p.type))
+        {
+        case SlotBool:
+            load_param(loaded, schema, p, bools);
+            break;
+        case SlotString:
+            load_param(loaded, schema, p, strings);
+            break;
+        case SlotInt32:
+            load_param<int32_t, true>(loaded, schema, p, int32s);
+            break;
+        case SlotUInt32:
+            load_param<uint32_t, true>(loaded, schema, p, uint32s);
+            break;
+        case SlotInt64:
+            load_param<long long, true>(loaded, schema, p, int64s);
+            break;
+        case SlotUInt64:
+            load_param<unsigned long long, true>(loaded, schema, p, uint64s);
+            break;
+#ifdef __SIZEOF_INT128__
+        case SlotInt128:
+            load_param<int128_t, true>(loaded, schema, p, int128s);
+            break;
+        case SlotUInt128:
+            load_param<uint128_t, true>(loaded, schema, p, uint128s);
+            break;
+#endif
+        case SlotFloat:
+            load_param(loaded, schema, p, floats);
+            break;
+        case SlotDouble:
+            load_param(loaded, schema, p, doubles);
+            break;
+        case SlotBlob:
+            load_param(loaded, schema, p, blobs);
+            break;
+        default:
+            throw Exception("Unsupported schema type.");
+        }
+    }
+    params.add_frozen(std::move(loaded), schema.index(), schema.indexed());
+}
+
+}
+
+#endif //PROGRAM_PARAMS_SCHEMA_H
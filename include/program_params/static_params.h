@@ -0,0 +1,610 @@
+/*
+Parameters declared by a compile-time schema (C++20) and read by name
+literals, e.g.,
+
+    typedef program_params::StaticParams<
+            program_params::Opt<int, "-c", "--count">,
+            program_params::Opt<std::string, "--name">,
+            program_params::Opt<bool, "-v">> Schema;
+    Schema params;
+    params.parse(argc - 1, argv + 1);
+    int count = params.get<"--count">();
+
+The schema owns storage of all values. Names are resolved to storage slots at
+compile time, so get is a single load, unknown names and mismatched types
+(get<"--count", long>()) are compile errors, and so are duplicate names.
+
+Parsing is that of Params, of which StaticParams is one, values with deferred
+interpolation are resolved by parse and set so that get never has to.
+
+Default command lines can be parsed in constant evaluation, into constant
+initialized values applied before parsing the real arguments:
+
+    constexpr auto defaults = Schema::parse_constant({"--count", "5", "-v"});
+    Schema params(defaults);
+
+Constant parsing supports bool, integer, floating-point (exact decimals only)
+and string parameters, errors in the defaults fail to compile.
+*/
+
+#ifndef PROGRAM_PARAMS_STATIC_PARAMS_H
+#define PROGRAM_PARAMS_STATIC_PARAMS_H
+
+#if __cplusplus < 202002L
+#error "program_params/static_params.h requires C++20."
+#endif
+
+#include <array>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <program_params/program_params.h>
+
+namespace program_params
+{
+
+/** String literal usable as template argument, e.g., "--count". */
+template<size_t N>
+struct Name
+{
+    constexpr Name(const char (&s)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            data[i] = s[i];
+        }
+    }
+    constexpr std::string_view view() const
+    {
+        return std::string_view(data, N - 1);
+    }
+
+    char data[N] = {};
+};
+
+/** Parameter of type T with given names, optional unless Required. */
+template<typename T, Name... Names>
+struct Opt
+{
+    static_assert(sizeof...(Names) > 0, "Parameter must have a name.");
+
+    typedef T type;
+    static constexpr bool required = false;
+    static constexpr std::string_view names[] = {Names.view()...};
+
+    template<Name N>
+    static constexpr bool has()
+    {
+        return ((Names.view() == N.view()) || ...);
+    }
+    static StrVec name_vec()
+    {
+        return StrVec{Str(Names.view())...};
+    }
+};
+
+template<typename T, Name... Names>
+struct Required: Opt<T, Names...>
+{
+    static constexpr bool required = true;
+};
+
+/** Storage of T in constant evaluation, strings view the arguments. */
+template<typename T>
+struct Constant
+{
+    typedef T type;
+};
+
+template<>
+struct Constant<Str>
+{
+    typedef std::string_view type;
+};
+
+constexpr int constant_digit(char c)
+{
+    return c >= '0' && c <= '9' ? c - '0'
+           : (c | 0x20) >= 'a' && (c | 0x20) <= 'f' ? (c | 0x20) - 'a' + 10 : -1;
+}
+
+/** Integer as by convert: sign, base prefix and digit separators. */
+template<typename T>
+constexpr T constant_integer(std::string_view s)
+{
+    typedef std::make_unsigned_t<T> U;
+    size_t i = 0;
+    bool negative = false;
+    if (i < s.size() && (s[i] == '+' || s[i] == '-'))
+    {
+        negative = s[i] == '-';
+        ++i;
+    }
+    if (negative && !std::is_signed_v<T>)
+    {
+        throw Exception("Parameter value out of range.");
+    }
+    const U limit = U(U(std::numeric_limits<T>::max()) + (negative ? 1 : 0));
+    unsigned base = 10;
+    if (s.size() - i > 2 && s[i] == '0')
+    {
+        switch (s[i + 1] | 0x20)
+        {
+        case 'x':
+            base = 16;
+            break;
+        case 'o':
+            base = 8;
+            break;
+        case 'b':
+            base = 2;
+            break;
+        }
+        i += base != 10 ? 2 : 0;
+    }
+    if (i == s.size())
+    {
+        throw Exception("Invalid parameter value.");
+    }
+    U x = 0;
+    bool digit = false;
+    for (; i < s.size(); ++i)
+    {
+        if (digit && (s[i] == '\'' || s[i] == '_') && i + 1 < s.size())
+        {
+            digit = false;
+            continue;
+        }
+        int d = constant_digit(s[i]);
+        if (d < 0 || unsigned(d) >= base)
+        {
+            throw Exception("Invalid parameter value.");
+        }
+        if (x > U((limit - U(d)) / base))
+        {
+            throw Exception("Parameter value out of range.");
+        }
+        x = U(x * base + U(d));
+        digit = true;
+    }
+    return negative && x > 0 ? T(-T(x - 1) - 1) : T(x);
+}
+
+/**
+ * Decimal floating-point number whose digits and power of ten are both exact
+ * in T, so that a single multiplication or division rounds correctly (the
+ * fast path of Clinger). Other numbers are errors.
+ */
+template<typename T>
+constexpr T constant_float(std::string_view s)
+{
+    size_t i = 0;
+    bool negative = false;
+    if (i < s.size() && (s[i] == '+' || s[i] == '-'))
+    {
+        negative = s[i] == '-';
+        ++i;
+    }
+    // Hexadecimal, infinity and NaN, which strtod accepts.
+    if (i < s.size() && ((s[i] | 0x20) == 'i' || (s[i] | 0x20) == 'n'
+                         || (s[i] == '0' && i + 1 < s.size() && (s[i + 1] | 0x20) == 'x')))
+    {
+        throw Exception("Parameter value not supported in constant evaluation.");
+    }
+    uint64_t m = 0;
+    int scale = 0;
+    bool digits = false;
+    bool point = false;
+    for (; i < s.size(); ++i)
+    {
+        if (s[i] == '.' && !point)
+        {
+            point = true;
+            continue;
+        }
+        if (s[i] < '0' || s[i] > '9')
+        {
+            break;
+        }
+        if (m > (std::numeric_limits<uint64_t>::max() - 9) / 10)
+        {
+            throw Exception("Parameter value not exact in constant evaluation.");
+        }
+        m = m * 10 + uint64_t(s[i] - '0');
+        scale -= point ? 1 : 0;
+        digits = true;
+    }
+    if (!digits)
+    {
+        throw Exception("Invalid parameter value.");
+    }
+    if (i < s.size() && (s[i] | 0x20) == 'e')
+    {
+        ++i;
+        bool minus = i < s.size() && s[i] == '-';
+        i += i < s.size() && (s[i] == '+' || s[i] == '-') ? 1 : 0;
+        if (i == s.size())
+        {
+            throw Exception("Invalid parameter value.");
+        }
+        int e = 0;
+        for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i)
+        {
+            e = e < 10000 ? e * 10 + (s[i] - '0') : e;
+        }
+        scale += minus ? -e : e;
+    }
+    if (i != s.size())
+    {
+        throw Exception("Invalid parameter value.");
+    }
+    const uint64_t max_mantissa = uint64_t(1) << std::numeric_limits<T>::digits;
+    int max_scale = 0;
+    for (uint64_t p = 5; p <= max_mantissa; p *= 5)
+    {
+        ++max_scale;
+    }
+    if (m > max_mantissa || (m != 0 && (scale > max_scale || scale < -max_scale)))
+    {
+        throw Exception("Parameter value not exact in constant evaluation.");
+    }
+    scale = m != 0 ? scale : 0;
+    T p = 1;
+    for (int k = 0; k < (scale < 0 ? -scale : scale); ++k)
+    {
+        p *= 10;
+    }
+    T x = scale < 0 ? T(m) / p : T(m) * p;
+    return negative ? -x : x;
+}
+
+/** Convert in constant evaluation: bool, integers, floats and strings. */
+template<typename T>
+constexpr void constant_convert(std::string_view value, T &target)
+{
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        if (value.empty() || value == "1" || value == "true" || value == "yes" || value == "on")
+        {
+            target = true;
+        }
+        else if (value == "0" || value == "false" || value == "no" || value == "off")
+        {
+            target = false;
+        }
+        else
+        {
+            throw Exception("Invalid parameter value.");
+        }
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        target = constant_integer<T>(value);
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        target = constant_float<T>(value);
+    }
+    else
+    {
+        static_assert(std::is_same_v<T, std::string_view>,
+                      "Type not supported in constant evaluation.");
+        target = value;
+    }
+}
+
+template<typename... Opts>
+class StaticParams: public Params
+{
+public:
+    typedef std::tuple<typename Opts::type...> Values;
+    static constexpr size_t size = sizeof...(Opts);
+
+    /** Values parsed in constant evaluation, strings view the arguments. */
+    struct Defaults
+    {
+        std::tuple<typename Constant<typename Opts::type>::type...> values;
+        bool found[size > 0 ? size : 1] = {};
+    };
+
+    explicit StaticParams(bool strict = true):
+            Params(strict)
+    {
+        static_assert(unique(), "Parameter names must be unique.");
+        add_all(std::index_sequence_for<Opts...>());
+        freeze();
+    }
+    /** Start with values of parameters found in defaults. */
+    explicit StaticParams(const Defaults &defaults, bool strict = true):
+            StaticParams(strict)
+    {
+        assign(defaults);
+    }
+    /** Parameters point into values, so they stay in place. */
+    StaticParams(const StaticParams &) = delete;
+    StaticParams &operator=(const StaticParams &) = delete;
+
+    /** Index of the parameter with name N, size if there is none. */
+    template<Name N>
+    static constexpr size_t index()
+    {
+        constexpr bool has[] = {Opts::template has<N>()...};
+        size_t i = 0;
+        while (i < size && !has[i])
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    using Params::get;
+
+    /** Value of the parameter with name N. */
+    template<Name N>
+    auto &get()
+    {
+        constexpr size_t i = index<N>();
+        static_assert(i < size, "Parameter not found.");
+#ifdef PROGRAM_PARAMS_COUNTERS
+        std::get<i < size ? i : 0>(slots_)->count_read();
+#endif
+        return std::get<i < size ? i : 0>(storage_);
+    }
+    template<Name N>
+    const auto &get() const
+    {
+        return const_cast<StaticParams *>(this)->get<N>();
+    }
+    /** Value of the parameter with name N, which must be of type T. */
+    template<Name N, typename T>
+    T &get()
+    {
+        static_assert(std::is_same<T, std::remove_reference_t<decltype(get<N>())>>::value,
+                      "Conversion not supported.");
+        return get<N>();
+    }
+    template<Name N, typename T>
+    const T &get() const
+    {
+        return const_cast<StaticParams *>(this)->get<N, T>();
+    }
+    /** Parameter with name N, e.g., to add constraints or help. */
+    template<Name N>
+    auto &param()
+    {
+        constexpr size_t i = index<N>();
+        static_assert(i < size, "Parameter not found.");
+        return *std::get<i < size ? i : 0>(slots_);
+    }
+    template<Name N>
+    bool found() const
+    {
+        return const_cast<StaticParams *>(this)->param<N>().found();
+    }
+    Values &values()
+    {
+        return storage_;
+    }
+    const Values &values() const
+    {
+        return storage_;
+    }
+
+    template<typename... Args>
+    size_t parse(Args &&... args)
+    {
+        size_t stop = Params::parse(std::forward<Args>(args)...);
+        resolve_all();
+        return stop;
+    }
+    size_t parse(std::initializer_list<const char *> args)
+    {
+        size_t stop = Params::parse(args);
+        resolve_all();
+        return stop;
+    }
+    void set(const StrRef &name, const StrRef &value)
+    {
+        Params::set(name, value);
+        resolve_all();
+    }
+
+    /**
+     * Parse arguments in constant evaluation as parse does in Interleave
+     * mode, strict, e.g., command lines baked into the binary:
+     *
+     *     constexpr auto defaults = Schema::parse_constant({"-c", "5", "-v"});
+     *     Schema params(defaults);
+     *     params.parse(argc - 1, argv + 1);
+     *
+     * Invalid arguments fail to compile. Values are checked by conversion
+     * only, not by constraints, and required parameters are not checked.
+     */
+    static constexpr Defaults parse_constant(std::initializer_list<std::string_view> args)
+    {
+        constexpr bool flags[] = {std::is_same_v<typename Opts::type, bool>..., false};
+        const auto table = names();
+        auto find = [&](std::string_view name)
+        {
+            size_t i = 0;
+            while (i < table.size() && table[i].first != name)
+            {
+                ++i;
+            }
+            return i < table.size() ? table[i].second : size;
+        };
+        auto value = [&](const std::string_view *it)
+        {
+            if (it + 1 >= args.end())
+            {
+                throw Exception("Missing parameter value.");
+            }
+            return it[1];
+        };
+        Defaults defaults;
+        size_t next = 0;
+        bool positional_onward = false;
+        for (const std::string_view *it = args.begin(); it < args.end();)
+        {
+            const std::string_view arg = *it;
+            if (positional_onward || arg.size() < 2 || arg[0] != '-')
+            {
+                while (next < size && table[first_names[next]].first[0] == '-')
+                {
+                    ++next;
+                }
+                if (next == size)
+                {
+                    throw Exception("Unknown positional parameter.");
+                }
+                set_constant(defaults, next++, arg);
+                ++it;
+            }
+            else if (arg == "--")
+            {
+                positional_onward = true;
+                ++it;
+            }
+            else if (arg[1] != '-')
+            {
+                // Short options, the last may take a value.
+                int inc = 1;
+                for (size_t i = 1; i < arg.size(); ++i)
+                {
+                    const char opt[] = {'-', arg[i]};
+                    size_t param = find(std::string_view(opt, 2));
+                    if (param == size)
+                    {
+                        throw Exception("Unknown short option.");
+                    }
+                    if (flags[param])
+                    {
+                        set_constant(defaults, param, std::string_view());
+                        continue;
+                    }
+                    std::string_view rest = arg.substr(i + 1);
+                    if (!rest.empty())
+                    {
+                        set_constant(defaults, param, rest[0] == '=' ? rest.substr(1) : rest);
+                    }
+                    else
+                    {
+                        set_constant(defaults, param, value(it));
+                        inc = 2;
+                    }
+                    break;
+                }
+                it += inc;
+            }
+            else
+            {
+                const size_t eq = std::min(arg.find('='), arg.size());
+                size_t param = find(arg.substr(0, eq));
+                if (param == size)
+                {
+                    throw Exception("Unknown long option.");
+                }
+                if (eq < arg.size())
+                {
+                    set_constant(defaults, param, arg.substr(eq + 1));
+                    it += 1;
+                }
+                else if (flags[param])
+                {
+                    set_constant(defaults, param, std::string_view());
+                    it += 1;
+                }
+                else
+                {
+                    set_constant(defaults, param, value(it));
+                    it += 2;
+                }
+            }
+        }
+        return defaults;
+    }
+    /** Set values of parameters found in defaults, which does not mark them found. */
+    void assign(const Defaults &defaults)
+    {
+        assign(defaults, std::index_sequence_for<Opts...>());
+    }
+private:
+    static constexpr size_t name_count = (std::size(Opts::names) + ... + 0);
+
+    /** Names with indices of their parameters, in order of declaration. */
+    static constexpr std::array<std::pair<std::string_view, size_t>, name_count> names()
+    {
+        std::array<std::pair<std::string_view, size_t>, name_count> table{};
+        size_t k = 0;
+        size_t param = 0;
+        auto append = [&](const auto &list)
+        {
+            for (auto name: list)
+            {
+                table[k++] = std::make_pair(name, param);
+            }
+            ++param;
+        };
+        (append(Opts::names), ...);
+        return table;
+    }
+    /** Index of the first name of each parameter in names(). */
+    static constexpr std::array<size_t, size> first_names = []
+    {
+        std::array<size_t, size> first{};
+        size_t k = 0;
+        size_t param = 0;
+        ((first[param++] = k, k += std::size(Opts::names)), ...);
+        return first;
+    }();
+
+    static constexpr bool unique()
+    {
+        const auto table = names();
+        for (size_t i = 0; i < table.size(); ++i)
+        {
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (table[i].first == table[j].first)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    static constexpr void set_constant(Defaults &defaults, size_t param, std::string_view value)
+    {
+        set_constant(defaults, param, value, std::index_sequence_for<Opts...>());
+    }
+    template<size_t... I>
+    static constexpr void set_constant(Defaults &defaults, size_t param, std::string_view value,
+                                       std::index_sequence<I...>)
+    {
+        ((param == I ? constant_convert(value, std::get<I>(defaults.values)) : void()), ...);
+        defaults.found[param] = true;
+    }
+    template<size_t... I>
+    void assign(const Defaults &defaults, std::index_sequence<I...>)
+    {
+        ((defaults.found[I]
+          ? void(std::get<I>(storage_) = typename Opts::type(std::get<I>(defaults.values)))
+          : void()), ...);
+    }
+    template<size_t... I>
+    void add_all(std::index_sequence<I...>)
+    {
+        ((std::get<I>(slots_) = &add(std::get<I>(storage_), Opts::name_vec(), Opts::required)), ...);
+    }
+    void resolve_all()
+    {
+        std::apply([this](auto *... p) { (resolve(*p), ...); }, slots_);
+    }
+
+    Values storage_;
+    std::tuple<Param<typename Opts::type> *...> slots_;
+};
+
+}
+
+#endif //PROGRAM_PARAMS_STATIC_PARAMS_H
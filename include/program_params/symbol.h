@@ -0,0 +1,205 @@
+/*
+Dictionary-encoded string parameters, for values repeating a small set of
+strings (regions, modes) across many parsed configurations:
+
+    program_params::Symbol region;
+    params.add(region, {"--region"});
+    params.parse(argc, argv);
+    if (region == eu_west) ...             // Compares 32-bit codes.
+    std::cout << region.str().str() << std::endl;
+
+Values are interned in a pool shared by the process and stored as their
+32-bit codes. Interning takes a lock, reading strings of codes does not.
+Interned strings stay until exit, so pools suit bounded sets of values.
+*/
+
+#ifndef PROGRAM_PARAMS_SYMBOL_H
+#define PROGRAM_PARAMS_SYMBOL_H
+
+#include <mutex>
+#include <program_params/program_params.h>
+
+namespace program_params
+{
+
+/**
+ * Interned strings, indexed by codes in order of interning, code 0 being the
+ * empty string. Codes obtained from any thread can be read without locking.
+ */
+class SymbolPool
+{
+public:
+    SymbolPool():
+            size_(0), block_used_(block_size)
+    {
+        intern(StrRef());
+    }
+    SymbolPool(const SymbolPool &) = delete;
+    SymbolPool &operator=(const SymbolPool &) = delete;
+
+    /** Pool shared by the process, used by Symbol. */
+    static SymbolPool &shared()
+    {
+        static SymbolPool pool;
+        return pool;
+    }
+
+    /** Code of s, interning a copy of s if new. */
+    uint32_t intern(const StrRef &s)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = codes_.find(s);
+        if (it != codes_.end())
+        {
+            return it->second;
+        }
+        if (size_ == std::numeric_limits<uint32_t>::max())
+        {
+            throw Exception("Symbol pool full.");
+        }
+        uint32_t code = size_;
+        size_t chunk = chunk_of(code);
+        if (!chunks_[chunk])
+        {
+            chunks_[chunk].reset(new StrRef[chunk_size << chunk]);
+        }
+        StrRef stored = store(s);
+        chunks_[chunk][code - chunk_begin(chunk)] = stored;
+        codes_.emplace(stored, code);
+        ++size_;
+        return code;
+    }
+    /** String of code returned by intern. */
+    StrRef str(uint32_t code) const
+    {
+        size_t chunk = chunk_of(code);
+        return chunks_[chunk][code - chunk_begin(chunk)];
+    }
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+private:
+    struct Hash
+    {
+        size_t operator()(const StrRef &s) const
+        {
+            return size_t(PerfectHash::hash(s));
+        }
+    };
+
+    static const size_t chunk_size = 256;
+    static const size_t chunk_count = 25;
+    static const size_t block_size = 65536;
+
+    /** Chunk c holds chunk_size << c codes, so chunks never move. */
+    static size_t chunk_of(uint32_t code)
+    {
+        return size_t(63 - __builtin_clzll(uint64_t(code) / chunk_size + 1));
+    }
+    static uint64_t chunk_begin(size_t chunk)
+    {
+        return chunk_size * ((uint64_t(1) << chunk) - 1);
+    }
+    /** Copy of s in blocks of characters which never move. */
+    StrRef store(const StrRef &s)
+    {
+        if (s.empty())
+        {
+            return StrRef();
+        }
+        if (s.size() > block_size / 4)
+        {
+            blocks_.emplace_back(new char[s.size()]);
+            std::memcpy(blocks_.back().get(), s.data(), s.size());
+            return StrRef(blocks_.back().get(), s.size());
+        }
+        if (block_used_ + s.size() > block_size)
+        {
+            blocks_.emplace_back(new char[block_size]);
+            block_ = blocks_.back().get();
+            block_used_ = 0;
+        }
+        char *p = block_ + block_used_;
+        std::memcpy(p, s.data(), s.size());
+        block_used_ += s.size();
+        return StrRef(p, s.size());
+    }
+
+    mutable std::mutex mutex_;
+    std::unordered_map<StrRef, uint32_t, Hash> codes_;
+    std::unique_ptr<StrRef[]> chunks_[chunk_count];
+    uint32_t size_;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char *block_ = nullptr;
+    size_t block_used_;
+};
+
+/** String interned in the shared pool, stored as its 32-bit code. */
+class Symbol
+{
+public:
+    Symbol():
+            code_(0)
+    {}
+    explicit Symbol(const StrRef &s):
+            code_(SymbolPool::shared().intern(s))
+    {}
+
+    uint32_t code() const
+    {
+        return code_;
+    }
+    StrRef str() const
+    {
+        return SymbolPool::shared().str(code_);
+    }
+    bool empty() const
+    {
+        return code_ == 0;
+    }
+    bool operator==(const Symbol &other) const
+    {
+        return code_ == other.code_;
+    }
+    bool operator!=(const Symbol &other) const
+    {
+        return code_ != other.code_;
+    }
+private:
+    uint32_t code_;
+};
+
+inline void convert(const StrRef &value, Symbol &target)
+{
+    target = Symbol(value);
+}
+
+inline TypeInfo type_info(const Symbol *)
+{
+    return TypeInfo{ValueType::String, false, 0, 0, Rounding::Exact};
+}
+
+inline Str format(const Symbol &value, Encoding)
+{
+    return value.str().str();
+}
+
+}
+
+namespace std
+{
+
+template<>
+struct hash<program_params::Symbol>
+{
+    size_t operator()(const program_params::Symbol &s) const
+    {
+        return s.code();
+    }
+};
+
+}
+
+#endif //PROGRAM_PARAMS_SYMBOL_H
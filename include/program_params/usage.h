@@ -0,0 +1,331 @@
+/*
+Parameters declared by a usage pattern, e.g.,
+
+    overview [-a] [-c|--count <count>] [-i|--interval <interval>] <destination>
+
+The pattern is parsed at compile time (C++14) into a table of elements which
+is then registered with Params in the order of the pattern:
+
+    PROGRAM_PARAMS_USAGE(params,
+            "overview [-a] [-c|--count <count>] <destination>",
+            audible, count, destination);
+
+- [...] marks an optional element, elements are required otherwise.
+- Options are -x or --name, alternative names are separated by |.
+- An option takes a value given as --name=<value>, or as --name <value>
+  within its own brackets, it is a flag otherwise.
+- A lone <name> is a positional parameter with given name, so in
+  "prog -v <file>", -v is a flag followed by a positional parameter.
+
+Malformed patterns, wrong number of targets and flags with non-bool targets
+are compile errors.
+*/
+
+#ifndef PROGRAM_PARAMS_USAGE_H
+#define PROGRAM_PARAMS_USAGE_H
+
+#if __cplusplus < 201402L
+#error "program_params/usage.h requires C++14."
+#endif
+
+#include <cstdint>
+#include <program_params/program_params.h>
+
+namespace program_params
+{
+
+struct UsageName
+{
+    const char *data = nullptr;
+    size_t size = 0;
+};
+
+struct UsageElement
+{
+    static constexpr size_t max_names = 4;
+
+    UsageName names[max_names] = {};
+    size_t name_count = 0;
+    bool optional = false;
+    bool value = false;
+    bool positional = false;
+
+    StrVec name_vec() const
+    {
+        StrVec v;
+        for (size_t i = 0; i < name_count; ++i)
+        {
+            v.emplace_back(names[i].data, names[i].size);
+        }
+        return v;
+    }
+};
+
+/** Compile-time parser of usage patterns. */
+class UsageParser
+{
+public:
+    constexpr explicit UsageParser(const char *pattern):
+            p_(pattern)
+    {}
+
+    /** Parse the pattern, storing up to cap elements to out if not null. */
+    constexpr size_t parse(UsageElement *out, size_t cap)
+    {
+        skip_space();
+        if (!*p_ || *p_ == '[' || *p_ == '<' || *p_ == '-')
+        {
+            throw Exception("Usage pattern must start with program name.");
+        }
+        while (*p_ && !is_space(*p_))
+        {
+            ++p_;
+        }
+        size_t n = 0;
+        for (skip_space(); *p_; skip_space())
+        {
+            UsageElement e;
+            if (*p_ == '[')
+            {
+                ++p_;
+                e.optional = true;
+                skip_space();
+                element(e);
+                skip_space();
+                expect(']');
+            }
+            else
+            {
+                element(e);
+            }
+            if (*p_ && !is_space(*p_))
+            {
+                throw Exception("Usage elements must be separated by space.");
+            }
+            if (out && n < cap)
+            {
+                out[n] = e;
+            }
+            ++n;
+        }
+        return n;
+    }
+private:
+    static constexpr bool is_space(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n';
+    }
+    static constexpr bool is_word(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+               || (c >= '0' && c <= '9') || c == '_' || c == '-';
+    }
+    constexpr void skip_space()
+    {
+        while (is_space(*p_))
+        {
+            ++p_;
+        }
+    }
+    constexpr void expect(char c)
+    {
+        if (*p_ != c)
+        {
+            throw Exception("Unexpected character in usage pattern.");
+        }
+        ++p_;
+    }
+    constexpr UsageName word()
+    {
+        UsageName name;
+        name.data = p_;
+        while (is_word(*p_))
+        {
+            ++p_;
+        }
+        name.size = size_t(p_ - name.data);
+        if (name.size == 0)
+        {
+            throw Exception("Missing name in usage pattern.");
+        }
+        return name;
+    }
+    /** <name> */
+    constexpr UsageName placeholder()
+    {
+        expect('<');
+        UsageName name = word();
+        expect('>');
+        return name;
+    }
+    /** -x or --name */
+    constexpr UsageName option()
+    {
+        UsageName name;
+        name.data = p_;
+        expect('-');
+        if (*p_ == '-')
+        {
+            ++p_;
+            word();
+        }
+        else if (is_word(*p_) && *p_ != '-')
+        {
+            ++p_;
+        }
+        else
+        {
+            throw Exception("Invalid option in usage pattern.");
+        }
+        name.size = size_t(p_ - name.data);
+        return name;
+    }
+    constexpr void element(UsageElement &e)
+    {
+        if (*p_ == '<')
+        {
+            e.positional = true;
+            e.names[0] = placeholder();
+            e.name_count = 1;
+            return;
+        }
+        for (;;)
+        {
+            if (e.name_count == UsageElement::max_names)
+            {
+                throw Exception("Too many alternative names in usage pattern.");
+            }
+            e.names[e.name_count++] = option();
+            if (*p_ != '|')
+            {
+                break;
+            }
+            ++p_;
+        }
+        // Value placeholder after =, or after a space within brackets.
+        if (*p_ == '=')
+        {
+            ++p_;
+            placeholder();
+            e.value = true;
+            return;
+        }
+        if (!e.optional)
+        {
+            return;
+        }
+        const char *q = p_;
+        skip_space();
+        if (*p_ == '<')
+        {
+            placeholder();
+            e.value = true;
+        }
+        else
+        {
+            p_ = q;
+        }
+    }
+
+    const char *p_;
+};
+
+/** Number of elements in the pattern. */
+constexpr size_t usage_size(const char *pattern)
+{
+    return UsageParser(pattern).parse(nullptr, 0);
+}
+
+/** Bit mask of flag elements (options without value) in the pattern. */
+constexpr uint64_t usage_flags(const char *pattern)
+{
+    UsageElement elements[64] = {};
+    size_t n = UsageParser(pattern).parse(elements, 64);
+    if (n > 64)
+    {
+        throw Exception("Too many elements in usage pattern.");
+    }
+    uint64_t mask = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (!elements[i].positional && !elements[i].value)
+        {
+            mask |= uint64_t(1) << i;
+        }
+    }
+    return mask;
+}
+
+/** Table of N elements parsed from a usage pattern. */
+template<size_t N>
+class Usage
+{
+public:
+    constexpr explicit Usage(const char *pattern):
+            pattern_(pattern), elements_{}
+    {
+        if (UsageParser(pattern).parse(elements_, N) != N)
+        {
+            throw Exception("Usage pattern size mismatch.");
+        }
+    }
+    constexpr const char *pattern() const
+    {
+        return pattern_;
+    }
+    constexpr size_t size() const
+    {
+        return N;
+    }
+    constexpr const UsageElement &operator[](size_t i) const
+    {
+        return elements_[i];
+    }
+private:
+    const char *pattern_;
+    UsageElement elements_[N > 0 ? N : 1];
+};
+
+template<uint64_t Flags, size_t I>
+void add_usage_targets(Params &, const UsageElement *)
+{}
+
+template<uint64_t Flags, size_t I, typename T, typename... Ts>
+void add_usage_targets(Params &params, const UsageElement *elements, T &target,
+                       Ts &... targets)
+{
+    static_assert(((Flags >> I) & 1) == std::is_same<T, bool>::value,
+                  "Usage flags require bool targets and vice versa.");
+    const UsageElement &e = elements[I];
+    params.add(target, e.name_vec(), !e.optional);
+    add_usage_targets<Flags, I + 1>(params, elements, targets...);
+}
+
+/** Register targets with params, in the order of usage elements. */
+template<size_t N, uint64_t Flags, typename... Ts>
+Usage<N> add_usage(Params &params, const Usage<N> &usage, Ts &... targets)
+{
+    static_assert(sizeof...(Ts) == N, "Number of targets must match usage pattern.");
+    add_usage_targets<Flags, 0>(params, &usage[0], targets...);
+    return usage;
+}
+
+}
+
+/**
+ * Parse usage pattern at compile time and register targets with params.
+ * Evaluates to the usage table, e.g., for printing the pattern.
+ */
+#define PROGRAM_PARAMS_USAGE(params, pattern, ...) \
+    program_params::add_usage<program_params::usage_size(pattern), \
+                              program_params::usage_flags(pattern)>( \
+        params, \
+        [] \
+        { \
+            constexpr program_params::Usage<program_params::usage_size(pattern)> \
+                    usage(pattern); \
+            return usage; \
+        }(), \
+        __VA_ARGS__)
+
+#endif //PROGRAM_PARAMS_USAGE_H